@@ -0,0 +1,85 @@
+/****************************************************************************
+ *
+ * (C) 2021 Cadence Design Systems, Inc. All rights reserved worldwide.
+ *
+ * This sample source code is not supported by Cadence Design Systems, Inc.
+ * It is provided freely for demonstration purposes only.
+ * SEE THE WARRANTY DISCLAIMER AT THE BOTTOM OF THIS FILE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+*
+* SU2 element type tables shared by the SU2 grid reader and writer
+*
+***************************************************************************/
+
+#ifndef _SU2ELEMTYPES_H_
+#define _SU2ELEMTYPES_H_
+
+#include <cstddef>
+
+
+// The SU2 (VTK) element type identifiers
+enum SU2ElemType {
+    SU2Line     = 3,
+    SU2Tri      = 5,
+    SU2Quad     = 9,
+    SU2Tet      = 10,
+    SU2Pyramid  = 14,
+    SU2Wedge    = 13,
+    SU2Hex      = 12
+};
+
+
+// The properties of an SU2 element type
+struct SU2ElemInfo {
+    SU2ElemType     type;       // SU2 type identifier
+    unsigned int    vertCnt;    // number of vertices
+    unsigned int    dimty;      // 1 (line), 2 (tri, quad) or 3 (cells)
+    const char *    name;       // name as published in ValidElements
+};
+
+
+static const SU2ElemInfo SU2ElemInfos[] = {
+    { SU2Line,      2, 1, "Bar" },
+    { SU2Tri,       3, 2, "Tri" },
+    { SU2Quad,      4, 2, "Quad" },
+    { SU2Tet,       4, 3, "Tet" },
+    { SU2Pyramid,   5, 3, "Pyramid" },
+    { SU2Wedge,     6, 3, "Wedge" },
+    { SU2Hex,       8, 3, "Hex" }
+};
+
+static const size_t SU2NumElemTypes =
+    sizeof(SU2ElemInfos) / sizeof(SU2ElemInfos[0]);
+
+// The largest vertex count of any SU2 element type
+static const unsigned int SU2MaxVertCnt = 8;
+
+
+// Get the properties of an SU2 element type. Returns 0 if su2Type is not a
+// supported type.
+static inline const SU2ElemInfo *
+su2ElemInfo(unsigned int su2Type)
+{
+    for (size_t ii = 0; ii < SU2NumElemTypes; ++ii) {
+        if (su2Type == unsigned(SU2ElemInfos[ii].type)) {
+            return &SU2ElemInfos[ii];
+        }
+    }
+    return 0;
+}
+
+#endif /* _SU2ELEMTYPES_H_ */
+
+
+/****************************************************************************
+ *
+ * This file is licensed under the Cadence Public License Version 1.0 (the
+ * "License"), a copy of which is found in the included file named "LICENSE",
+ * and is distributed "AS IS." TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE
+ * LAW, CADENCE DISCLAIMS ALL WARRANTIES AND IN NO EVENT SHALL BE LIABLE TO
+ * ANY PARTY FOR ANY DAMAGES ARISING OUT OF OR RELATING TO USE OF THIS FILE.
+ * Please see the License for the full text of applicable terms.
+ *
+ ****************************************************************************/
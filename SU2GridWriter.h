@@ -0,0 +1,343 @@
+/****************************************************************************
+ *
+ * (C) 2021 Cadence Design Systems, Inc. All rights reserved worldwide.
+ *
+ * This sample source code is not supported by Cadence Design Systems, Inc.
+ * It is provided freely for demonstration purposes only.
+ * SEE THE WARRANTY DISCLAIMER AT THE BOTTOM OF THIS FILE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+*
+* SU2 grid file writer
+*
+* Writes the SU2 grid format read by the SU2 grid import plugin. The writer
+* does not depend on the PluginSDK so it can also be used by stand-alone
+* tools, such as benchmarks that need SU2 files of a known size and content.
+*
+* Blocks are formatted in chunks of lines. Up to numThreads chunks are
+* formatted in parallel into separate buffers that are then written in
+* order, so the output is the same for any thread count. Reals are always
+* written with 17 significant digits, so the output is also the same for any
+* compiler and language standard.
+*
+***************************************************************************/
+
+#ifndef _SU2GRIDWRITER_H_
+#define _SU2GRIDWRITER_H_
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#   include <charconv>
+#endif
+
+#include "SU2ElemTypes.h"
+
+
+class SU2GridWriter {
+public:
+
+    // Writes to fp which must be open for binary writing. numThreads of 0
+    // uses all cores. chunkLines is the number of lines formatted by each
+    // thread at a time.
+    SU2GridWriter(FILE *fp, unsigned int numThreads = 0,
+            size_t chunkLines = 64 * 1024) :
+        fp_(fp),
+        numThreads_(numThreads),
+        chunkLines_(std::max(chunkLines, size_t(1))),
+        dimty_(3),
+        ok_(0 != fp),
+        types_(0),
+        conn_(0),
+        xyz_(0),
+        indexed_(false),
+        chunkOffsets_(),
+        bufs_()
+    {
+        if (0 == numThreads_) {
+            numThreads_ = std::max(std::thread::hardware_concurrency(), 1U);
+        }
+    }
+
+    ~SU2GridWriter() {}
+
+
+    // Write the "NDIME= dimty" line. dimty must be 2 or 3.
+    bool
+    writeDimension(unsigned int dimty)
+    {
+        dimty_ = dimty;
+        ok_ = ok_ && ((2 == dimty) || (3 == dimty)) &&
+            writeKeyVal("NDIME", dimty);
+        return ok_;
+    }
+
+
+    // Write the NELEM block. types holds the SU2 type of each element and
+    // conn holds the vertex indices of all the elements back to back.
+    bool
+    writeElements(const unsigned int *types, size_t numElems,
+        const unsigned int *conn)
+    {
+        ok_ = ok_ && writeKeyVal("NELEM", numElems) &&
+            writeConnectivity(types, numElems, conn, true);
+        return ok_;
+    }
+
+
+    // Write the NPOIN block. xyz holds the x, y (and z if 3D) coordinates of
+    // each point.
+    bool
+    writePoints(const double *xyz, size_t numPoints)
+    {
+        xyz_ = xyz;
+        ok_ = ok_ && writeKeyVal("NPOIN", numPoints) &&
+            writeLines(numPoints, &SU2GridWriter::formatPoints);
+        return ok_;
+    }
+
+
+    // Write the "NMARK= numMarkers" line. It must be followed by numMarkers
+    // calls to writeMarker().
+    bool
+    writeMarkerCount(size_t numMarkers)
+    {
+        ok_ = ok_ && writeKeyVal("NMARK", numMarkers);
+        return ok_;
+    }
+
+
+    // Write a marker block. types and conn are as in writeElements().
+    bool
+    writeMarker(const char *name, const unsigned int *types,
+        size_t numElems, const unsigned int *conn)
+    {
+        ok_ = ok_ && (0 != name) &&
+            (0 <= fprintf(fp_, "MARKER_TAG= %s\n", name)) &&
+            writeKeyVal("MARKER_ELEMS", numElems) &&
+            writeConnectivity(types, numElems, conn, false);
+        return ok_;
+    }
+
+
+    // Returns false if any write has failed.
+    bool
+    ok() const
+    {
+        return ok_;
+    }
+
+
+    // Write val as a decimal integer at p. Returns the end of the written
+    // characters.
+    static inline char *
+    putUInt(char *p, unsigned long long val)
+    {
+        static const char Digits[] =
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899";
+        char buf[24];
+        char *b = buf + sizeof(buf);
+        while (val >= 100) {
+            const unsigned int ii = unsigned(val % 100) * 2;
+            val /= 100;
+            *--b = Digits[ii + 1];
+            *--b = Digits[ii];
+        }
+        if (val >= 10) {
+            const unsigned int ii = unsigned(val) * 2;
+            *--b = Digits[ii + 1];
+            *--b = Digits[ii];
+        }
+        else {
+            *--b = char('0' + val);
+        }
+        const size_t n = size_t(buf + sizeof(buf) - b);
+        memcpy(p, b, n);
+        return p + n;
+    }
+
+
+    // Write val at p with enough digits to be read back exactly. end must
+    // leave room for at least MaxRealChars characters. Returns the end of
+    // the written characters.
+    static inline char *
+    putReal(char *p, char *end, double val)
+    {
+#if defined(__cpp_lib_to_chars) && (__cpp_lib_to_chars >= 201611L)
+        // Same characters as "%.17g" without parsing a format string
+        return std::to_chars(p, end, val, std::chars_format::general,
+            17).ptr;
+#else
+        return p + snprintf(p, size_t(end - p), "%.17g", val);
+#endif
+    }
+
+
+private:
+
+    enum {
+        MaxRealChars = 32,      // max chars written by putReal()
+        MaxLineChars = 256      // max chars in any formatted line
+    };
+
+    typedef std::vector<char>   Buffer;
+
+    // Formats lines [begin, end) of the current block into buf.
+    typedef char * (SU2GridWriter::*FormatFn)(size_t begin, size_t end,
+        char *buf) const;
+
+    // Write a "KEY= val" line.
+    bool
+    writeKeyVal(const char *key, size_t val)
+    {
+        return 0 <= fprintf(fp_, "%s= %lu\n", key, (unsigned long)val);
+    }
+
+    // Write "Type Vertex1 ... VertexN [Index]" lines.
+    bool
+    writeConnectivity(const unsigned int *types, size_t numElems,
+        const unsigned int *conn, bool indexed)
+    {
+        types_ = types;
+        conn_ = conn;
+        indexed_ = indexed;
+        // Lines vary in length, so find the conn_ offset of each chunk first
+        chunkOffsets_.assign(1, 0);
+        size_t offset = 0;
+        bool ret = true;
+        for (size_t ii = 0; ret && (ii < numElems); ++ii) {
+            const SU2ElemInfo *info = su2ElemInfo(types[ii]);
+            ret = (0 != info);
+            if (ret) {
+                offset += info->vertCnt;
+                if (0 == ((ii + 1) % chunkLines_)) {
+                    chunkOffsets_.push_back(offset);
+                }
+            }
+        }
+        return ret && writeLines(numElems, &SU2GridWriter::formatElements);
+    }
+
+    // Format and write numLines lines of the current block. Up to
+    // numThreads_ chunks are formatted in parallel and written in order.
+    bool
+    writeLines(size_t numLines, FormatFn fn)
+    {
+        const size_t numChunks = (numLines + chunkLines_ - 1) / chunkLines_;
+        const size_t batchSize = std::min(size_t(numThreads_), numChunks);
+        bufs_.resize(batchSize);
+        std::vector<char *> ends(batchSize);
+        bool ret = true;
+        for (size_t chunk = 0; ret && (chunk < numChunks);
+                chunk += batchSize) {
+            const size_t n = std::min(batchSize, numChunks - chunk);
+            std::vector<std::thread> threads;
+            for (size_t ii = 1; ii < n; ++ii) {
+                threads.push_back(std::thread(formatChunk, this, fn,
+                    chunk + ii, numLines, std::ref(bufs_[ii]),
+                    std::ref(ends[ii])));
+            }
+            // This thread does the first chunk of the batch
+            formatChunk(this, fn, chunk, numLines, bufs_[0], ends[0]);
+            for (size_t ii = 0; ii < threads.size(); ++ii) {
+                threads[ii].join();
+            }
+            for (size_t ii = 0; ret && (ii < n); ++ii) {
+                const size_t len = size_t(ends[ii] - &bufs_[ii][0]);
+                ret = (len == fwrite(&bufs_[ii][0], 1, len, fp_));
+            }
+        }
+        return ret;
+    }
+
+    // Format the lines of chunk into buf.
+    static void
+    formatChunk(const SU2GridWriter *writer, FormatFn fn, size_t chunk,
+        size_t numLines, Buffer &buf, char *&end)
+    {
+        const size_t begin = chunk * writer->chunkLines_;
+        const size_t last = std::min(begin + writer->chunkLines_, numLines);
+        buf.resize((last - begin) * MaxLineChars);
+        end = (writer->*fn)(begin, last, &buf[0]);
+    }
+
+    // Format elements [begin, end) of types_ and conn_.
+    char *
+    formatElements(size_t begin, size_t end, char *p) const
+    {
+        const unsigned int *conn = conn_ + chunkOffsets_[begin / chunkLines_];
+        for (size_t ii = begin; ii < end; ++ii) {
+            const unsigned int cnt = su2ElemInfo(types_[ii])->vertCnt;
+            p = putUInt(p, types_[ii]);
+            for (unsigned int jj = 0; jj < cnt; ++jj) {
+                *p++ = '\t';
+                p = putUInt(p, *conn++);
+            }
+            if (indexed_) {
+                *p++ = '\t';
+                p = putUInt(p, ii);
+            }
+            *p++ = '\n';
+        }
+        return p;
+    }
+
+    // Format points [begin, end) of xyz_.
+    char *
+    formatPoints(size_t begin, size_t end, char *p) const
+    {
+        const double *xyz = xyz_ + begin * dimty_;
+        for (size_t ii = begin; ii < end; ++ii) {
+            for (unsigned int jj = 0; jj < dimty_; ++jj) {
+                p = putReal(p, p + MaxRealChars, *xyz++);
+                *p++ = '\t';
+            }
+            p = putUInt(p, ii);
+            *p++ = '\n';
+        }
+        return p;
+    }
+
+    // hide copy constructor
+    SU2GridWriter(const SU2GridWriter&);
+
+    // hide assignment operator
+    SU2GridWriter & operator=(const SU2GridWriter&);
+
+private:
+    FILE *                  fp_;            // output file
+    unsigned int            numThreads_;    // max threads formatting chunks
+    size_t                  chunkLines_;    // lines per chunk
+    unsigned int            dimty_;         // grid dimensionality (2 or 3)
+    bool                    ok_;            // false after a write fails
+    const unsigned int *    types_;         // current block element types
+    const unsigned int *    conn_;          // current block connectivity
+    const double *          xyz_;           // current block coordinates
+    bool                    indexed_;       // true if lines end with index
+    std::vector<size_t>     chunkOffsets_;  // conn_ offset of each chunk
+    std::vector<Buffer>     bufs_;          // per-thread format buffers
+};
+
+#endif /* _SU2GRIDWRITER_H_ */
+
+
+/****************************************************************************
+ *
+ * This file is licensed under the Cadence Public License Version 1.0 (the
+ * "License"), a copy of which is found in the included file named "LICENSE",
+ * and is distributed "AS IS." TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE
+ * LAW, CADENCE DISCLAIMS ALL WARRANTIES AND IN NO EVENT SHALL BE LIABLE TO
+ * ANY PARTY FOR ANY DAMAGES ARISING OUT OF OR RELATING TO USE OF THIS FILE.
+ * Please see the License for the full text of applicable terms.
+ *
+ ****************************************************************************/
@@ -0,0 +1,218 @@
+/****************************************************************************
+ *
+ * (C) 2021 Cadence Design Systems, Inc. All rights reserved worldwide.
+ *
+ * This sample source code is not supported by Cadence Design Systems, Inc.
+ * It is provided freely for demonstration purposes only.
+ * SEE THE WARRANTY DISCLAIMER AT THE BOTTOM OF THIS FILE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+*
+* Platform queries used to plan an import
+*
+* All queries are best effort. A value that cannot be determined on the
+* current platform is reported as unknown (0 or FsUnknown) rather than as an
+* error.
+*
+***************************************************************************/
+
+#ifndef _SYSTEMINFO_H_
+#define _SYSTEMINFO_H_
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#if defined(_WIN32)
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>
+#   include <sys/stat.h>
+#else
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   if defined(__linux__)
+#       include <sys/vfs.h>
+#   elif defined(__APPLE__)
+#       include <sys/mount.h>
+#       include <sys/param.h>
+#       include <sys/sysctl.h>
+#   endif
+#endif
+
+
+// The kind of file system holding a file
+enum FsKind {
+    FsUnknown,      // could not be determined
+    FsLocal,        // local disk
+    FsMemory,       // memory backed (e.g. tmpfs)
+    FsNetwork       // remote (e.g. NFS, SMB, Lustre)
+};
+
+
+// Get the size of the regular file at path. Returns false if path is not a
+// regular file, for example a pipe.
+static inline bool
+regularFileSize(const char *path, unsigned long long &size)
+{
+#if defined(_WIN32)
+    struct _stat64 st;
+    const bool ret = (0 == _stat64(path, &st)) &&
+        (0 != (st.st_mode & _S_IFREG));
+#else
+    struct stat st;
+    const bool ret = (0 == stat(path, &st)) && S_ISREG(st.st_mode);
+#endif
+    size = ret ? (unsigned long long)st.st_size : 0;
+    return ret;
+}
+
+
+// Get the kind and name of the file system holding path.
+static inline FsKind
+fileSystemOf(const char *path, std::string &name)
+{
+    FsKind ret = FsUnknown;
+    name = "unknown";
+#if defined(__linux__)
+    // statfs() magic numbers from linux/magic.h and the file system sources
+    static const struct {
+        unsigned long   magic;
+        const char *    name;
+        FsKind          kind;
+    } Types[] = {
+        { 0x0000EF53UL, "ext",     FsLocal },
+        { 0x58465342UL, "xfs",     FsLocal },
+        { 0x9123683EUL, "btrfs",   FsLocal },
+        { 0x2FC12FC1UL, "zfs",     FsLocal },
+        { 0x794C7630UL, "overlay", FsLocal },
+        { 0x01021994UL, "tmpfs",   FsMemory },
+        { 0x858458F6UL, "ramfs",   FsMemory },
+        { 0x00006969UL, "nfs",     FsNetwork },
+        { 0x0000517BUL, "smb",     FsNetwork },
+        { 0xFF534D42UL, "cifs",    FsNetwork },
+        { 0xFE534D42UL, "smb2",    FsNetwork },
+        { 0x0BD00BD0UL, "lustre",  FsNetwork },
+        { 0x47504653UL, "gpfs",    FsNetwork },
+        { 0x00C36400UL, "ceph",    FsNetwork },
+        { 0x65735546UL, "fuse",    FsNetwork },
+    };
+    struct statfs st;
+    if (0 == statfs(path, &st)) {
+        ret = FsLocal;
+        name = "local";
+        const unsigned long magic = (unsigned long)st.f_type & 0xFFFFFFFFUL;
+        for (size_t ii = 0; ii < sizeof(Types) / sizeof(Types[0]); ++ii) {
+            if (Types[ii].magic == magic) {
+                ret = Types[ii].kind;
+                name = Types[ii].name;
+                break;
+            }
+        }
+    }
+#elif defined(__APPLE__)
+    struct statfs st;
+    if (0 == statfs(path, &st)) {
+        name = st.f_fstypename;
+        ret = (st.f_flags & MNT_LOCAL) ? FsLocal : FsNetwork;
+    }
+#elif defined(_WIN32)
+    char full[MAX_PATH];
+    char root[MAX_PATH];
+    if (GetFullPathNameA(path, MAX_PATH, full, 0) &&
+            GetVolumePathNameA(full, root, MAX_PATH)) {
+        switch (GetDriveTypeA(root)) {
+        case DRIVE_REMOTE:
+            ret = FsNetwork;
+            name = "remote";
+            break;
+        case DRIVE_RAMDISK:
+            ret = FsMemory;
+            name = "ramdisk";
+            break;
+        case DRIVE_FIXED:
+        case DRIVE_REMOVABLE:
+        case DRIVE_CDROM:
+            ret = FsLocal;
+            name = "local";
+            break;
+        default:
+            break;
+        }
+    }
+#else
+    (void)path;
+#endif
+    return ret;
+}
+
+
+// The physical memory available to this process without swapping in bytes.
+// Returns 0 if unknown.
+static inline unsigned long long
+availableMemory()
+{
+    unsigned long long ret = 0;
+#if defined(_WIN32)
+    MEMORYSTATUSEX ms;
+    ms.dwLength = sizeof(ms);
+    if (GlobalMemoryStatusEx(&ms)) {
+        ret = ms.ullAvailPhys;
+    }
+#elif defined(__linux__)
+    // MemAvailable includes reclaimable page cache, _SC_AVPHYS_PAGES does not
+    FILE *fp = fopen("/proc/meminfo", "r");
+    if (fp) {
+        char line[256];
+        unsigned long long kb = 0;
+        while (fgets(line, sizeof(line), fp)) {
+            if (1 == sscanf(line, "MemAvailable: %llu kB", &kb)) {
+                ret = kb << 10;
+                break;
+            }
+        }
+        fclose(fp);
+    }
+    if (0 == ret) {
+        const long pages = sysconf(_SC_AVPHYS_PAGES);
+        const long pageSz = sysconf(_SC_PAGESIZE);
+        if ((0 < pages) && (0 < pageSz)) {
+            ret = (unsigned long long)pages * (unsigned long long)pageSz;
+        }
+    }
+#elif defined(__APPLE__)
+    // No portable "available" count. Use half the physical memory.
+    unsigned long long mem = 0;
+    size_t len = sizeof(mem);
+    if (0 == sysctlbyname("hw.memsize", &mem, &len, 0, 0)) {
+        ret = mem / 2;
+    }
+#endif
+    return ret;
+}
+
+
+// The number of hardware threads. Returns at least 1.
+static inline unsigned int
+numCores()
+{
+    const unsigned int ret = std::thread::hardware_concurrency();
+    return (0 == ret) ? 1 : ret;
+}
+
+#endif /* _SYSTEMINFO_H_ */
+
+
+/****************************************************************************
+ *
+ * This file is licensed under the Cadence Public License Version 1.0 (the
+ * "License"), a copy of which is found in the included file named "LICENSE",
+ * and is distributed "AS IS." TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE
+ * LAW, CADENCE DISCLAIMS ALL WARRANTIES AND IN NO EVENT SHALL BE LIABLE TO
+ * ANY PARTY FOR ANY DAMAGES ARISING OUT OF OR RELATING TO USE OF THIS FILE.
+ * Please see the License for the full text of applicable terms.
+ *
+ ****************************************************************************/
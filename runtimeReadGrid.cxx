@@ -16,9 +16,15 @@
 #include <algorithm>
 #include <cctype>
 #include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstdio>
 #include <cstdlib> 
+#include <cstring>
 #include <functional> 
 #include <sstream>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "apiGRDP.h"
@@ -26,236 +32,1912 @@
 #include "apiPWP.h"
 #include "PwpFile.h"
 #include "runtimeReadGrid.h"
+#include "SU2ElemTypes.h"
+#include "SystemInfo.h"
+
+#if !defined(_WIN32)
+#   include <sys/wait.h>
+#endif
 
 
 typedef std::vector<std::string>    StringArray1;
+typedef std::chrono::steady_clock   Clock;
+
+static const PWGM_HVERTEXLIST   BadVertList = PWGM_HVERTEXLIST_INIT;
+static const PWGM_ELEMCOUNTS    ZeroCounts = { {0} };
+
+// A compressed file format imported through an external decompressor
+struct SU2Compression {
+    const char *    name;       // format name
+    const char *    magic;      // leading bytes of a compressed file
+    size_t          magicLen;   // number of bytes in magic
+    const char *    command;    // writes the decompressed file to stdout
+};
+
+static const SU2Compression SU2Compressions[] = {
+    { "gzip",  "\x1F\x8B",             2, "gzip -dc" },
+    { "bzip2", "BZh",                  3, "bzip2 -dc" },
+    { "xz",    "\xFD" "7zXZ\x00",       6, "xz -dc" },
+    { "zstd",  "\x28\xB5\x2F\xFD",     4, "zstd -dc" },
+};
+
+static const size_t SU2NumCompressions =
+    sizeof(SU2Compressions) / sizeof(SU2Compressions[0]);
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// Compact staging store for element connectivity.
+//
+// Elements are packed by type into per-type slab arenas (struct-of-arrays).
+// Within a type, an element's first vertex index is stored as the delta from
+// the previous element's first vertex and its remaining indices as deltas
+// from its own first vertex. Deltas are zigzag and varint encoded. A one byte
+// tag per element records its type so elements are replayed in file order.
+//
+// Slabs are never reallocated once created and no element straddles two
+// slabs. Every CheckpointInterval elements the decoder state is recorded so
+// a Cursor can seek() without replaying the elements before the checkpoint.
+// The store never grows beyond the limit given to setLimit().
+class SU2ElemStore {
+public:
+
+    SU2ElemStore() :
+        limit_(0),
+        bytes_(0),
+        count_(0),
+        tags_(),
+        data_(),
+        checkpoints_()
+    {
+        for (int ii = 0; ii < NumSlots; ++ii) {
+            prev_[ii] = 0;
+        }
+    }
+
+    ~SU2ElemStore() {}
+
+
+    // Set the maximum number of bytes the store may allocate. 0 is unlimited.
+    void
+    setLimit(size_t limit)
+    {
+        limit_ = limit;
+    }
+
+
+    // Append an element. Returns false if su2Type is not a known element type
+    // or if the element would exceed the memory limit.
+    bool
+    push(PWP_UINT32 su2Type, const PWP_UINT32 *verts)
+    {
+        const int slot = slotOf(su2Type);
+        bool ret = (0 <= slot) && ((0 != count_ % CheckpointInterval) ||
+            addCheckpoint());
+        if (ret) {
+            // Encode the element, then copy it into the slot's current slab
+            unsigned char buf[MaxElemBytes];
+            unsigned char *p = putVarint(buf, zigzag(verts[0], prev_[slot]));
+            for (PWP_UINT32 ii = 1; ii < SlotVertCnt[slot]; ++ii) {
+                p = putVarint(p, zigzag(verts[ii], verts[0]));
+            }
+            const unsigned char tag = static_cast<unsigned char>(slot);
+            ret = append(tags_, &tag, 1) && append(data_[slot], buf, p - buf);
+            if (ret) {
+                prev_[slot] = verts[0];
+                ++count_;
+            }
+            else if (0 == count_ % CheckpointInterval) {
+                // The element was not added so neither is its checkpoint
+                checkpoints_.pop_back();
+                bytes_ -= sizeof(Checkpoint);
+            }
+        }
+        return ret;
+    }
+
+
+    // The maximum number of bytes the store may allocate. 0 is unlimited.
+    size_t
+    limit() const
+    {
+        return limit_;
+    }
+
+
+    // Exchange the contents of this store with other.
+    void
+    swap(SU2ElemStore &other)
+    {
+        std::swap(limit_, other.limit_);
+        std::swap(bytes_, other.bytes_);
+        std::swap(count_, other.count_);
+        tags_.swap(other.tags_);
+        for (int ii = 0; ii < NumSlots; ++ii) {
+            data_[ii].swap(other.data_[ii]);
+            std::swap(prev_[ii], other.prev_[ii]);
+        }
+        checkpoints_.swap(other.checkpoints_);
+    }
+
+
+    // Release all memory held by the store. The limit is retained.
+    void
+    clear()
+    {
+        Arena().swap(tags_);
+        for (int ii = 0; ii < NumSlots; ++ii) {
+            Arena().swap(data_[ii]);
+            prev_[ii] = 0;
+        }
+        std::vector<Checkpoint>().swap(checkpoints_);
+        bytes_ = 0;
+        count_ = 0;
+    }
+
+
+    // The number of elements in the store.
+    size_t
+    size() const
+    {
+        return count_;
+    }
+
+
+    // The number of bytes allocated by the store.
+    size_t
+    bytes() const
+    {
+        return bytes_;
+    }
+
+
+    // Replays the elements of a store in the order they were pushed.
+    class Cursor;
+
+
+private:
+
+    typedef std::vector<unsigned char>  Slab;
+    typedef std::vector<Slab>           Arena;
+
+    enum {
+        NumSlots = 6,               // number of supported element types
+        MaxElemBytes = SU2MaxVertCnt * 5, // max encoded size of an element
+        MinSlabBytes = 4 * 1024,    // size of the first slab of an arena
+        MaxSlabBytes = 1024 * 1024, // slabs double in size up to this
+        CheckpointInterval = 4096   // elements between checkpoints
+    };
+
+    // A position in an arena
+    struct Pos {
+        Pos() : slab(0), off(0) {}
+        size_t  slab;   // index of the slab
+        size_t  off;    // byte offset in the slab
+    };
+
+    // The decoder state before an element
+    struct Checkpoint {
+        Checkpoint() :
+            tag(),
+            data()
+        {
+            for (int ii = 0; ii < NumSlots; ++ii) {
+                prev[ii] = 0;
+            }
+        }
+        Pos         tag;                // position of the element's tag
+        Pos         data[NumSlots];     // next data position of each slot
+        PWP_UINT32  prev[NumSlots];     // last first vertex of each slot
+    };
+
+    static const PWP_UINT32 SlotType[NumSlots];
+    static const PWP_UINT32 SlotVertCnt[NumSlots];
+
+    // Get the slot used to store an SU2 element type. Returns -1 if su2Type
+    // is not supported.
+    static int
+    slotOf(PWP_UINT32 su2Type)
+    {
+        for (int ii = 0; ii < NumSlots; ++ii) {
+            if (SlotType[ii] == su2Type) {
+                return ii;
+            }
+        }
+        return -1;
+    }
+
+    // Zigzag encode the signed difference val - base.
+    static inline PWP_UINT64
+    zigzag(PWP_UINT32 val, PWP_UINT32 base)
+    {
+        const PWP_INT64 d = PWP_INT64(val) - PWP_INT64(base);
+        return (PWP_UINT64(d) << 1) ^ PWP_UINT64(d >> 63);
+    }
+
+    // Inverse of zigzag()
+    static inline PWP_UINT32
+    unzigzag(PWP_UINT64 zz, PWP_UINT32 base)
+    {
+        const PWP_INT64 d = PWP_INT64(zz >> 1) ^ -PWP_INT64(zz & 1);
+        return PWP_UINT32(PWP_INT64(base) + d);
+    }
+
+    // Write val as a base 128 varint. Returns the end of the written bytes.
+    static inline unsigned char *
+    putVarint(unsigned char *p, PWP_UINT64 val)
+    {
+        while (val >= 0x80) {
+            *p++ = static_cast<unsigned char>(val | 0x80);
+            val >>= 7;
+        }
+        *p++ = static_cast<unsigned char>(val);
+        return p;
+    }
+
+    // Read a base 128 varint and advance p past it.
+    static inline PWP_UINT64
+    getVarint(const unsigned char *&p)
+    {
+        PWP_UINT64 val = 0;
+        int shift = 0;
+        while (*p & 0x80) {
+            val |= PWP_UINT64(*p++ & 0x7f) << shift;
+            shift += 7;
+        }
+        val |= PWP_UINT64(*p++) << shift;
+        return val;
+    }
+
+    // Copy n bytes into the arena's last slab, starting a new slab if there
+    // is not enough room. Returns false if the new slab would exceed limit_.
+    bool
+    append(Arena &arena, const unsigned char *buf, size_t n)
+    {
+        if (arena.empty() || (arena.back().size() + n >
+                arena.back().capacity())) {
+            const size_t cap = arena.empty() ? size_t(MinSlabBytes) :
+                std::min(size_t(MaxSlabBytes), 2 * arena.back().capacity());
+            if ((0 != limit_) && (bytes_ + cap > limit_)) {
+                return false;
+            }
+            arena.push_back(Slab());
+            arena.back().reserve(cap);
+            bytes_ += arena.back().capacity();
+        }
+        arena.back().insert(arena.back().end(), buf, buf + n);
+        return true;
+    }
+
+    // Get the end of an arena as a position.
+    static Pos
+    endOf(const Arena &arena)
+    {
+        Pos pos;
+        if (!arena.empty()) {
+            pos.slab = arena.size() - 1;
+            pos.off = arena.back().size();
+        }
+        return pos;
+    }
+
+    // Record the decoder state before the next element. Returns false if the
+    // checkpoint would exceed limit_.
+    bool
+    addCheckpoint()
+    {
+        if ((0 != limit_) && (bytes_ + sizeof(Checkpoint) > limit_)) {
+            return false;
+        }
+        Checkpoint cp;
+        cp.tag = endOf(tags_);
+        for (int ii = 0; ii < NumSlots; ++ii) {
+            cp.data[ii] = endOf(data_[ii]);
+            cp.prev[ii] = prev_[ii];
+        }
+        checkpoints_.push_back(cp);
+        bytes_ += sizeof(Checkpoint);
+        return true;
+    }
+
+    // hide copy constructor
+    SU2ElemStore(const SU2ElemStore&);
+
+    // hide assignment operator
+    SU2ElemStore & operator=(const SU2ElemStore&);
+
+private:
+    size_t      limit_;             // max bytes allocated (0 is unlimited)
+    size_t      bytes_;             // bytes allocated by all slabs
+    size_t      count_;             // number of elements
+    Arena       tags_;              // slot of each element in push order
+    Arena       data_[NumSlots];    // encoded vertex indices by slot
+    PWP_UINT32  prev_[NumSlots];    // last first vertex pushed to each slot
+    std::vector<Checkpoint> checkpoints_; // state every CheckpointInterval
+};
+
+const PWP_UINT32 SU2ElemStore::SlotType[SU2ElemStore::NumSlots] = {
+    SU2Tri, SU2Quad, SU2Tet, SU2Pyramid, SU2Wedge, SU2Hex
+};
+
+const PWP_UINT32 SU2ElemStore::SlotVertCnt[SU2ElemStore::NumSlots] = {
+    3, 4, 4, 5, 6, 8
+};
+
+
+// Replays the elements of an SU2ElemStore in the order they were pushed.
+class SU2ElemStore::Cursor {
+public:
+
+    Cursor(const SU2ElemStore &store) :
+        store_(store),
+        at_(),
+        ndx_(0)
+    {}
+
+    ~Cursor() {}
+
+
+    // Get the next element. verts must have room for SU2MaxVertCnt. Returns
+    // false when all elements have been replayed.
+    bool
+    next(PWP_UINT32 &su2Type, PWP_UINT32 *verts, PWP_UINT32 &cnt)
+    {
+        const unsigned char *p = get(store_.tags_, at_.tag);
+        bool ret = (0 != p);
+        if (ret) {
+            const int slot = *p;
+            ++at_.tag.off;
+            ++ndx_;
+            su2Type = SlotType[slot];
+            cnt = SlotVertCnt[slot];
+            Pos &pos = at_.data[slot];
+            PWP_UINT32 &prev = at_.prev[slot];
+            const unsigned char *start = get(store_.data_[slot], pos);
+            p = start;
+            verts[0] = prev = unzigzag(getVarint(p), prev);
+            for (PWP_UINT32 ii = 1; ii < cnt; ++ii) {
+                verts[ii] = unzigzag(getVarint(p), verts[0]);
+            }
+            pos.off += (p - start);
+        }
+        return ret;
+    }
+
+
+    // Move past the next element without decoding all of its vertices.
+    // Returns false when all elements have been replayed.
+    bool
+    skip()
+    {
+        const unsigned char *p = get(store_.tags_, at_.tag);
+        bool ret = (0 != p);
+        if (ret) {
+            const int slot = *p;
+            ++at_.tag.off;
+            ++ndx_;
+            Pos &pos = at_.data[slot];
+            PWP_UINT32 &prev = at_.prev[slot];
+            const unsigned char *start = get(store_.data_[slot], pos);
+            p = start;
+            // The first vertex is needed to decode the next one of the type
+            prev = unzigzag(getVarint(p), prev);
+            for (PWP_UINT32 ii = 1; ii < SlotVertCnt[slot]; ++ii) {
+                while (*p++ & 0x80) {
+                }
+            }
+            pos.off += (p - start);
+        }
+        return ret;
+    }
+
+
+    // Move forward so the next element is the one at ndx in push order. Jumps
+    // to the last checkpoint at or before ndx if it is ahead of the cursor.
+    // Does nothing if the cursor is already past ndx.
+    void
+    seek(size_t ndx)
+    {
+        const size_t cp = ndx / CheckpointInterval;
+        if ((cp < store_.checkpoints_.size()) &&
+                (cp * CheckpointInterval > ndx_)) {
+            at_ = store_.checkpoints_[cp];
+            ndx_ = cp * CheckpointInterval;
+        }
+        while ((ndx_ < ndx) && skip()) {
+        }
+    }
+
+private:
+
+    // Get the data at pos, moving to the next slab if needed. Returns 0
+    // at the end of arena.
+    static const unsigned char *
+    get(const Arena &arena, Pos &pos)
+    {
+        while ((pos.slab < arena.size()) &&
+                (pos.off >= arena[pos.slab].size())) {
+            ++pos.slab;
+            pos.off = 0;
+        }
+        return (pos.slab < arena.size()) ? &arena[pos.slab][pos.off] : 0;
+    }
+
+    // hide assignment operator
+    Cursor & operator=(const Cursor&);
+
+private:
+    const SU2ElemStore &    store_;     // the store being replayed
+    Checkpoint              at_;        // decoder state before next element
+    size_t                  ndx_;       // index of the next element
+};
+
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// A set of grid points stored as one bit per point. After buildRank() is
+// called, rank() maps a point in the set to its position among the points in
+// the set. This is used to compact and renumber the points of a grid subset.
+class VertexMask {
+public:
+
+    VertexMask() :
+        size_(0),
+        bits_(),
+        ranks_()
+    {}
+
+    ~VertexMask() {}
+
+
+    // Size the mask for n points and clear all bits.
+    void
+    resize(PWP_UINT32 n)
+    {
+        size_ = n;
+        bits_.assign((size_t(n) + 63) / 64, 0);
+        ranks_.clear();
+    }
+
+
+    // The number of points covered by the mask.
+    PWP_UINT32
+    size() const
+    {
+        return size_;
+    }
+
+
+    // Add point ndx to the set. ndx must be less than size().
+    void
+    set(PWP_UINT32 ndx)
+    {
+        bits_[ndx >> 6] |= (PWP_UINT64(1) << (ndx & 63));
+    }
+
+
+    // Returns true if point ndx is in the set. ndx must be less than size().
+    bool
+    test(PWP_UINT32 ndx) const
+    {
+        return 0 != (bits_[ndx >> 6] & (PWP_UINT64(1) << (ndx & 63)));
+    }
+
+
+    // Returns true if any of the cnt points in verts are in the set.
+    bool
+    testAny(const PWP_UINT32 *verts, PWP_UINT32 cnt) const
+    {
+        for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
+            if (test(verts[ii])) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+
+    // Compute the rank of each 64 point word. Must be called after the last
+    // call to set() and before calling rank() or count().
+    void
+    buildRank()
+    {
+        ranks_.resize(bits_.size() + 1);
+        ranks_[0] = 0;
+        for (size_t ii = 0; ii < bits_.size(); ++ii) {
+            ranks_[ii + 1] = ranks_[ii] + popcount(bits_[ii]);
+        }
+    }
+
+
+    // The number of points in the set before point ndx.
+    PWP_UINT32
+    rank(PWP_UINT32 ndx) const
+    {
+        const PWP_UINT64 below = (PWP_UINT64(1) << (ndx & 63)) - 1;
+        return ranks_[ndx >> 6] + popcount(bits_[ndx >> 6] & below);
+    }
+
+
+    // The number of points in the set.
+    PWP_UINT32
+    count() const
+    {
+        return ranks_.empty() ? 0 : ranks_.back();
+    }
+
+
+    // Exchange the contents of this mask with other.
+    void
+    swap(VertexMask &other)
+    {
+        std::swap(size_, other.size_);
+        bits_.swap(other.bits_);
+        ranks_.swap(other.ranks_);
+    }
+
+
+private:
+
+    // The number of bits set in val.
+    static inline PWP_UINT32
+    popcount(PWP_UINT64 val)
+    {
+        val -= (val >> 1) & 0x5555555555555555ULL;
+        val = (val & 0x3333333333333333ULL) +
+            ((val >> 2) & 0x3333333333333333ULL);
+        val = (val + (val >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+        return PWP_UINT32((val * 0x0101010101010101ULL) >> 56);
+    }
+
+private:
+    PWP_UINT32              size_;  // number of points covered
+    std::vector<PWP_UINT64> bits_;  // one bit per point
+    std::vector<PWP_UINT32> ranks_; // number of set bits before each word
+};
+
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// Finds the exterior boundary faces of the 3D cells in an SU2ElemStore.
+//
+// Every tri and quad face of every cell is counted by its sorted vertex
+// indices. A boundary face occurs exactly once. Faces shared by two (or, in
+// non-manifold grids, more) cells are interior.
+//
+// The cells are split into one contiguous range per thread and the faces
+// are sharded by hash, one shard per thread. The cells are processed in
+// batches, each in two parallel steps with no locking. First, each thread
+// decodes a batch of cells from its range, builds their faces and routes
+// them to their shards. Second, each thread counts the faces routed to its
+// shard. Every cell is decoded once and every face is counted once.
+//
+// The counts are keyed by the sorted indices only. Each count keeps the cell
+// and face number it was first seen on, and the outward ordered vertices of
+// the boundary faces are decoded from those cells at the end.
+class BoundaryFaces {
+public:
+
+    struct Face {
+        PWP_UINT32  verts[4];   // vertex indices ordered outward
+        PWP_UINT32  cnt;        // 3 (tri) or 4 (quad)
+    };
+
+    typedef std::vector<Face>   FaceArray1;
+
+
+    // Find the boundary faces of the cells in store using numThreads
+    // threads. The faces are sorted by their sorted vertex indices so the
+    // result does not depend on numThreads.
+    static void
+    find(const SU2ElemStore &store, PWP_UINT32 numThreads, FaceArray1 &faces)
+    {
+        numThreads = std::max(numThreads, PWP_UINT32(1));
+        // Position a cursor at the start of each thread's range of cells
+        const size_t rangeSize = (store.size() + numThreads - 1) / numThreads;
+        std::vector<SU2ElemStore::Cursor> curs(numThreads,
+            SU2ElemStore::Cursor(store));
+        for (PWP_UINT32 ii = 0; ii < numThreads; ++ii) {
+            curs[ii].seek(ii * rangeSize);
+        }
+        // routed[range][shard] holds the faces of the current batch
+        std::vector<std::vector<FaceUseArray1> > routed(numThreads,
+            std::vector<FaceUseArray1>(numThreads));
+        std::vector<FaceMap> maps(numThreads);
+        std::vector<std::thread> threads;
+        for (size_t done = 0; done < rangeSize; done += BatchSize) {
+            const size_t batch = std::min(size_t(BatchSize), rangeSize - done);
+            for (PWP_UINT32 ii = 1; ii < numThreads; ++ii) {
+                threads.push_back(std::thread(routeBatch, std::ref(curs[ii]),
+                    ii * rangeSize + done, batch, std::ref(routed[ii])));
+            }
+            // This thread does range 0
+            routeBatch(curs[0], done, batch, routed[0]);
+            joinAll(threads);
+            for (PWP_UINT32 ii = 1; ii < numThreads; ++ii) {
+                threads.push_back(std::thread(countShard, std::ref(routed),
+                    ii, std::ref(maps[ii])));
+            }
+            // This thread does shard 0
+            countShard(routed, 0, maps[0]);
+            joinAll(threads);
+        }
+        FaceUseArray1 uses;
+        for (PWP_UINT32 ii = 0; ii < numThreads; ++ii) {
+            for (FaceMap::const_iterator it = maps[ii].begin();
+                    it != maps[ii].end(); ++it) {
+                if (1 == it->second.count) {
+                    uses.push_back(*it);
+                }
+            }
+            FaceMap().swap(maps[ii]);
+        }
+        std::sort(uses.begin(), uses.end(), lessKey);
+        outwardFaces(store, uses, faces);
+    }
+
+
+private:
+
+    // A cell face as cell local vertex indices ordered outward.
+    struct FaceDef {
+        PWP_UINT32  cnt;        // 3 (tri) or 4 (quad)
+        PWP_UINT32  ndx[4];     // cell local vertex indices
+    };
+
+    // The sorted vertex indices of a face. A tri's fourth index is
+    // 0xffffffff.
+    struct FaceKey {
+        PWP_UINT32  key[4];
+    };
+
+    // Where a face was first seen and how often
+    struct FaceUse {
+        PWP_UINT32      cell;   // index of the cell in the store
+        unsigned char   face;   // index of the face in the cell's FaceDefs
+        unsigned char   count;  // number of occurrences, at most 2
+    };
+
+    struct FaceKeyHash {
+        size_t
+        operator()(const FaceKey &face) const
+        {
+            return size_t(hash(face));
+        }
+    };
+
+    struct FaceKeyEqual {
+        bool
+        operator()(const FaceKey &lhs, const FaceKey &rhs) const
+        {
+            return std::equal(lhs.key, lhs.key + 4, rhs.key);
+        }
+    };
+
+    enum {
+        BatchSize = 64 * 1024   // cells decoded by each thread per batch
+    };
+
+    typedef std::pair<FaceKey, FaceUse>     FaceKeyUse;
+    typedef std::vector<FaceKeyUse>         FaceUseArray1;
+    typedef std::unordered_map<FaceKey, FaceUse, FaceKeyHash, FaceKeyEqual>
+        FaceMap;
+
+    static inline PWP_UINT64
+    hash(const FaceKey &face)
+    {
+        PWP_UINT64 h = 0x9e3779b97f4a7c15ULL;
+        for (int ii = 0; ii < 4; ++ii) {
+            h = (h ^ face.key[ii]) * 0xff51afd7ed558ccdULL;
+            h ^= (h >> 32);
+        }
+        return h;
+    }
+
+    static bool
+    lessKey(const FaceKeyUse &lhs, const FaceKeyUse &rhs)
+    {
+        return std::lexicographical_compare(lhs.first.key,
+            lhs.first.key + 4, rhs.first.key, rhs.first.key + 4);
+    }
+
+    static bool
+    lessCell(const FaceKeyUse *lhs, const FaceKeyUse *rhs)
+    {
+        return lhs->second.cell < rhs->second.cell;
+    }
+
+    // Get the faces of an SU2 cell type. The SU2 (VTK) vertex ordering is
+    // assumed. Returns 0 for types that are not 3D cells.
+    static const FaceDef *
+    faceDefs(PWP_UINT32 su2Type, PWP_UINT32 &numFaces)
+    {
+        static const FaceDef TetFaces[] = {
+            { 3, { 0, 2, 1 } }, { 3, { 0, 1, 3 } }, { 3, { 1, 2, 3 } },
+            { 3, { 2, 0, 3 } }
+        };
+        static const FaceDef PyramidFaces[] = {
+            { 4, { 0, 3, 2, 1 } }, { 3, { 0, 1, 4 } }, { 3, { 1, 2, 4 } },
+            { 3, { 2, 3, 4 } }, { 3, { 3, 0, 4 } }
+        };
+        static const FaceDef WedgeFaces[] = {
+            { 3, { 0, 1, 2 } }, { 3, { 3, 5, 4 } }, { 4, { 0, 3, 4, 1 } },
+            { 4, { 1, 4, 5, 2 } }, { 4, { 2, 5, 3, 0 } }
+        };
+        static const FaceDef HexFaces[] = {
+            { 4, { 0, 3, 2, 1 } }, { 4, { 4, 5, 6, 7 } }, { 4, { 0, 1, 5, 4 } },
+            { 4, { 1, 2, 6, 5 } }, { 4, { 2, 3, 7, 6 } }, { 4, { 3, 0, 4, 7 } }
+        };
+        switch (su2Type) {
+        case SU2Tet:
+            numFaces = 4;
+            return TetFaces;
+        case SU2Pyramid:
+            numFaces = 5;
+            return PyramidFaces;
+        case SU2Wedge:
+            numFaces = 5;
+            return WedgeFaces;
+        case SU2Hex:
+            numFaces = 6;
+            return HexFaces;
+        }
+        numFaces = 0;
+        return 0;
+    }
+
+    // Sort the cnt (3 or 4) vertex indices of a face key.
+    static inline void
+    sortKey(PWP_UINT32 *key, PWP_UINT32 cnt)
+    {
+        for (PWP_UINT32 ii = 1; ii < cnt; ++ii) {
+            const PWP_UINT32 val = key[ii];
+            PWP_UINT32 jj = ii;
+            for (; (0 < jj) && (val < key[jj - 1]); --jj) {
+                key[jj] = key[jj - 1];
+            }
+            key[jj] = val;
+        }
+    }
+
+    // Use the high bits of the hash to pick the shard of a face. The maps use
+    // the low bits to pick a bucket.
+    static inline PWP_UINT32
+    shardOf(const FaceKey &face, PWP_UINT32 numShards)
+    {
+        return PWP_UINT32((hash(face) >> 40) % numShards);
+    }
+
+    // Decode the next batch cells at cur, the first of which is cell first,
+    // and route their faces to their shards in routed.
+    static void
+    routeBatch(SU2ElemStore::Cursor &cur, size_t first, size_t batch,
+        std::vector<FaceUseArray1> &routed)
+    {
+        const PWP_UINT32 numShards = PWP_UINT32(routed.size());
+        PWP_UINT32 su2Type;
+        PWP_UINT32 verts[SU2MaxVertCnt];
+        PWP_UINT32 cnt;
+        PWP_UINT32 numFaces;
+        FaceKeyUse face;
+        face.second.count = 1;
+        for (size_t nn = 0; (nn < batch) && cur.next(su2Type, verts, cnt);
+                ++nn) {
+            const FaceDef *defs = faceDefs(su2Type, numFaces);
+            face.second.cell = PWP_UINT32(first + nn);
+            for (PWP_UINT32 ii = 0; ii < numFaces; ++ii) {
+                PWP_UINT32 *key = face.first.key;
+                face.second.face = static_cast<unsigned char>(ii);
+                key[3] = 0xffffffff;
+                for (PWP_UINT32 jj = 0; jj < defs[ii].cnt; ++jj) {
+                    key[jj] = verts[defs[ii].ndx[jj]];
+                }
+                sortKey(key, defs[ii].cnt);
+                routed[shardOf(face.first, numShards)].push_back(face);
+            }
+        }
+    }
+
+    // Count the faces routed to shard by all ranges in map. The routed faces
+    // are cleared for the next batch.
+    static void
+    countShard(std::vector<std::vector<FaceUseArray1> > &routed,
+        PWP_UINT32 shard, FaceMap &map)
+    {
+        for (size_t ii = 0; ii < routed.size(); ++ii) {
+            FaceUseArray1 &in = routed[ii][shard];
+            for (size_t jj = 0; jj < in.size(); ++jj) {
+                const std::pair<FaceMap::iterator, bool> res =
+                    map.insert(in[jj]);
+                if (!res.second) {
+                    res.first->second.count = 2;
+                }
+            }
+            in.clear();
+        }
+    }
+
+    // Get the outward ordered vertices of each face in uses from the cell it
+    // was seen on. The cells are decoded in store order.
+    static void
+    outwardFaces(const SU2ElemStore &store, const FaceUseArray1 &uses,
+        FaceArray1 &faces)
+    {
+        std::vector<const FaceKeyUse *> byCell(uses.size());
+        for (size_t ii = 0; ii < uses.size(); ++ii) {
+            byCell[ii] = &uses[ii];
+        }
+        std::sort(byCell.begin(), byCell.end(), lessCell);
+        faces.resize(uses.size());
+        SU2ElemStore::Cursor cur(store);
+        PWP_UINT32 su2Type = 0;
+        PWP_UINT32 verts[SU2MaxVertCnt];
+        PWP_UINT32 cnt;
+        PWP_UINT32 numFaces;
+        for (size_t ii = 0; ii < byCell.size(); ++ii) {
+            const FaceUse &use = byCell[ii]->second;
+            if ((0 == ii) || (use.cell != byCell[ii - 1]->second.cell)) {
+                cur.seek(use.cell);
+                cur.next(su2Type, verts, cnt);
+            }
+            const FaceDef &def = faceDefs(su2Type, numFaces)[use.face];
+            Face &face = faces[byCell[ii] - &uses[0]];
+            face.cnt = def.cnt;
+            for (PWP_UINT32 jj = 0; jj < def.cnt; ++jj) {
+                face.verts[jj] = verts[def.ndx[jj]];
+            }
+        }
+    }
+
+    // Join and remove all threads.
+    static void
+    joinAll(std::vector<std::thread> &threads)
+    {
+        for (size_t ii = 0; ii < threads.size(); ++ii) {
+            threads[ii].join();
+        }
+        threads.clear();
+    }
+};
+
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// trim leading whitespace
+static inline std::string &
+ltrim(std::string &s)
+{
+    s.erase(s.begin(), std::find_if(s.begin(), s.end(),
+        std::not1(std::ptr_fun<int, int>(std::isspace))));
+    return s;
+}
+
+
+// trim trailing whitespace
+static inline std::string &
+rtrim(std::string &s)
+{
+    s.erase(std::find_if(s.rbegin(), s.rend(),
+        std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
+    return s;
+}
+
+
+// trim leading and trailing whitespace
+static inline std::string &
+trim(std::string &s)
+{
+    return ltrim(rtrim(s));
+}
+
+
+// Convert a char* of specified base to an integer value of type T.
+template<typename T>
+static inline bool
+toInt(const char *str, T &val, const int base = 10)
+{
+    char* endptr = 0;
+    if (str && ('\0' != *str)) {
+        errno = 0;
+        val = static_cast<T>(strtol(str, &endptr, base));
+        if (0 != errno) {
+            endptr = 0;
+        }
+    }
+    return endptr && ('\0' == *endptr);
+}
+
+
+// Convert a std::string of specified base to an integer value of type T.
+template<typename T>
+static inline bool
+toInt(const std::string &str, T &val, const int base = 10)
+{
+    return toInt(str.c_str(), val, base);
+}
+
+
+// Convert a char* to a floating point value of type T.
+template<typename T>
+static inline bool
+toDbl(const char *str, T &val)
+{
+    char* endptr = 0;
+    if (str && ('\0' != *str)) {
+        errno = 0;
+        val = strtod(str, &endptr);
+        if (0 != errno) {
+            endptr = 0;
+        }
+    }
+    return endptr && ('\0' == *endptr);
+}
+
+
+// Convert a std::string to a floating point value of type T.
+template<typename T>
+static inline bool
+toDbl(const std::string &str, T &val)
+{
+    return toDbl(str.c_str(), val);
+}
+
+
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+//---------------------------------------------------------------------------
+
+// A parser engine reads the non-empty, non-comment lines of an SU2 file and
+// converts the line's whitespace separated tokens. Engines are selected with
+// the ParserEngine attribute. All engines must produce identical results.
+// The ParserVerify attribute runs two engines side by side to check this.
+class SU2Parser {
+public:
+
+    SU2Parser() :
+        fp_(0),
+        lineNum_(0)
+    {}
+
+    virtual ~SU2Parser() {}
+
+
+    // Read lines from fp. Clears the current line.
+    void
+    setFile(FILE *fp)
+    {
+        fp_ = fp;
+        lineNum_ = 0;
+        clear();
+    }
+
+
+    // The number of lines read from the file, including skipped lines.
+    PWP_UINT64
+    lineNum() const
+    {
+        return lineNum_;
+    }
+
+
+    // The engine name as used by the ParserEngine attribute.
+    virtual const char * name() const = 0;
+
+    // Read the next non-empty, non-comment line. Returns false if EOF.
+    virtual bool readLine() = 0;
+
+    // Clear the current line.
+    virtual void clear() = 0;
+
+    // The current line without leading and trailing whitespace.
+    virtual const char * text() const = 0;
+
+    // The number of tokens in the current line.
+    virtual size_t numToks() const = 0;
+
+    // Convert token ndx of the current line to an integer.
+    virtual bool tokUInt(size_t ndx, PWP_UINT32 &val) const = 0;
+
+    // Convert token ndx of the current line to a real.
+    virtual bool tokReal(size_t ndx, PWP_REAL &val) const = 0;
+
+
+protected:
+
+    // Size of the line buffer. Longer lines are split.
+    static const size_t BufSz = 1024;
+
+protected:
+    FILE *      fp_;        // the file being read
+    PWP_UINT64  lineNum_;   // number of lines read
+};
+
+
+// The original std::string based parser. Each line is copied into a
+// std::string and split into std::string tokens with a std::stringstream.
+class SU2LegacyParser : public SU2Parser {
+public:
+
+    SU2LegacyParser() :
+        line_(),
+        toks_(),
+        haveToks_(false)
+    {}
+
+    virtual ~SU2LegacyParser() {}
+
+
+    virtual const char *
+    name() const
+    {
+        return "Legacy";
+    }
+
+
+    virtual bool
+    readLine()
+    {
+        char buf[BufSz];
+        bool ret = false;
+        haveToks_ = false;
+        while (fgets(buf, BufSz, fp_)) {
+            ++lineNum_;
+            line_ = buf;
+            if (trim(line_).empty() || ('%' == line_.at(0))) {
+                // line_ is empty or comment - skip and get next
+                continue;
+            }
+            ret = true;
+            break;
+        }
+        return ret;
+    }
+
+
+    virtual void
+    clear()
+    {
+        line_.clear();
+        haveToks_ = false;
+    }
+
+
+    virtual const char *
+    text() const
+    {
+        return line_.c_str();
+    }
+
+
+    virtual size_t
+    numToks() const
+    {
+        return toks().size();
+    }
+
+
+    virtual bool
+    tokUInt(size_t ndx, PWP_UINT32 &val) const
+    {
+        return (ndx < toks().size()) && toInt(toks_[ndx], val);
+    }
+
+
+    virtual bool
+    tokReal(size_t ndx, PWP_REAL &val) const
+    {
+        return (ndx < toks().size()) && toDbl(toks_[ndx], val);
+    }
+
+
+private:
+
+    // Split line_ into tokens (space delimited) the first time they are used.
+    const StringArray1 &
+    toks() const
+    {
+        if (!haveToks_) {
+            toks_.clear();
+            std::string lineBuf;
+            std::stringstream ss(line_);
+            while (ss >> lineBuf) {
+                // capture whitespace separated tokens
+                toks_.push_back(lineBuf);
+            }
+            haveToks_ = true;
+        }
+        return toks_;
+    }
+
+private:
+    std::string             line_;      // the current line
+    mutable StringArray1    toks_;      // the current line's tokens
+    mutable bool            haveToks_;  // true if toks_ is for line_
+};
+
+
+// A parser that works in place on the line buffer. Tokens are located with
+// a single scan of the line and integers are converted without copying.
+// Reals are converted with the same strtod() call as the Legacy engine.
+class SU2FastParser : public SU2Parser {
+public:
+
+    SU2FastParser() :
+        text_(buf_),
+        numToks_(0)
+    {
+        buf_[0] = '\0';
+    }
+
+    virtual ~SU2FastParser() {}
+
+
+    virtual const char *
+    name() const
+    {
+        return "Fast";
+    }
+
+
+    virtual bool
+    readLine()
+    {
+        bool ret = false;
+        numToks_ = 0;
+        while (fgets(buf_, BufSz, fp_)) {
+            ++lineNum_;
+            // trim leading and trailing whitespace in place
+            char *p = buf_;
+            while (isspace((unsigned char)*p)) {
+                ++p;
+            }
+            char *end = p + strlen(p);
+            while ((end > p) && isspace((unsigned char)end[-1])) {
+                --end;
+            }
+            *end = '\0';
+            if ((end == p) || ('%' == *p)) {
+                // line is empty or comment - skip and get next
+                continue;
+            }
+            text_ = p;
+            tokenize(p, end);
+            ret = true;
+            break;
+        }
+        if (!ret) {
+            clear();
+        }
+        return ret;
+    }
+
+
+    virtual void
+    clear()
+    {
+        buf_[0] = '\0';
+        text_ = buf_;
+        numToks_ = 0;
+    }
+
+
+    virtual const char *
+    text() const
+    {
+        return text_;
+    }
+
+
+    virtual size_t
+    numToks() const
+    {
+        return numToks_;
+    }
+
+
+    // Matches strtol() followed by a cast to PWP_UINT32, including a leading
+    // sign, the range of long and the wrap of negative values.
+    virtual bool
+    tokUInt(size_t ndx, PWP_UINT32 &val) const
+    {
+        if (ndx >= numToks_) {
+            return false;
+        }
+        const char *p = toks_[ndx].begin;
+        const char *end = p + toks_[ndx].len;
+        const bool neg = ('-' == *p);
+        if (neg || ('+' == *p)) {
+            ++p;
+        }
+        const unsigned long MaxMag = (unsigned long)LONG_MAX + (neg ? 1 : 0);
+        unsigned long mag = 0;
+        bool ret = (p < end);
+        for (; ret && (p < end); ++p) {
+            const unsigned int digit = unsigned(*p - '0');
+            ret = (digit < 10) && (mag <= (MaxMag - digit) / 10);
+            mag = (mag * 10) + digit;
+        }
+        if (ret) {
+            val = static_cast<PWP_UINT32>(neg ? (0 - mag) : mag);
+        }
+        return ret;
+    }
 
-static const PWGM_HVERTEXLIST   BadVertList = PWGM_HVERTEXLIST_INIT;
-static const PWGM_ELEMCOUNTS    ZeroCounts = { {0} };
 
-enum SU2ElemType {
-    SU2Tri      = 5,
-    SU2Quad     = 9,
-    SU2Tet      = 10,
-    SU2Pyramid  = 14,
-    SU2Wedge    = 13,
-    SU2Hex      = 12
+    virtual bool
+    tokReal(size_t ndx, PWP_REAL &val) const
+    {
+        bool ret = (ndx < numToks_);
+        if (ret) {
+            // strtod() needs a terminated copy of the token
+            char tok[BufSz];
+            memcpy(tok, toks_[ndx].begin, toks_[ndx].len);
+            tok[toks_[ndx].len] = '\0';
+            ret = toDbl(tok, val);
+        }
+        return ret;
+    }
+
+
+private:
+
+    // Locate the whitespace separated tokens of [p, end).
+    void
+    tokenize(const char *p, const char *end)
+    {
+        numToks_ = 0;
+        while ((p < end) && (numToks_ < MaxToks)) {
+            while ((p < end) && isspace((unsigned char)*p)) {
+                ++p;
+            }
+            if (p == end) {
+                break;
+            }
+            const char *tok = p;
+            while ((p < end) && !isspace((unsigned char)*p)) {
+                ++p;
+            }
+            toks_[numToks_].begin = tok;
+            toks_[numToks_].len = size_t(p - tok);
+            ++numToks_;
+        }
+        // Count, but do not keep, any tokens past MaxToks
+        for (bool inTok = false; p < end; ++p) {
+            const bool space = (0 != isspace((unsigned char)*p));
+            if (!space && !inTok) {
+                ++numToks_;
+            }
+            inTok = !space;
+        }
+    }
+
+    struct Tok {
+        const char *    begin;  // start of token in buf_
+        size_t          len;    // length of token
+    };
+
+    // No valid SU2 line has more tokens than this
+    static const size_t MaxToks = SU2MaxVertCnt + 4;
+
+private:
+    char        buf_[BufSz];        // the line buffer
+    const char *text_;              // start of the trimmed line in buf_
+    Tok         toks_[MaxToks];     // the current line's tokens
+    size_t      numToks_;           // number of tokens in the current line
 };
 
+
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 //---------------------------------------------------------------------------
 
 class SU2GridReader {
 public:
+
+    // Values of the ExtractBoundary attribute
+    enum BoundaryMode {
+        BoundaryNever,      // never extract the boundary
+        BoundaryNoMarkers,  // extract the boundary if the file has no markers
+        BoundaryAlways      // always extract the boundary
+    };
    
     SU2GridReader(GRDP_RTITEM *pRti) :
         pRti_(pRti),
         in_(),
-        line_(),
+        legacy_(),
+        fast_(),
+        parser_(&legacy_),
         posNELEMData_(),
         posNPOINData_(),
+        posTailData_(),
         gridIs3D_(false),
+        streaming_(false),
+        pipe_(0),
+        compression_(0),
+        fileSize_(0),
+        threads_(1),
+        bufSize_(0),
+        startTime_(),
+        boundary_(BoundaryNever),
+        store_(),
         nPoints_(0),
         nElems_(0),
         nElemTypes_(ZeroCounts),
+        used_(),
         hVL_(BadVertList)
     {}
 
-    ~SU2GridReader() {}
+    ~SU2GridReader()
+    {
+        closePipe();
+    }
 
 
     PWP_BOOL read()
     {
-        const PWP_UINT32 NumMajorSteps = 4;
-        return grdpProgressEnd(pRti_, grdpProgressInit(pRti_, NumMajorSteps) &&
-            init() && readVertices() && loadCells());
+        // open() settles the backend, which sets the number of steps
+        const bool ret = plan() && open() &&
+            grdpProgressInit(pRti_, numMajorSteps()) && verifyParsers() &&
+            (streaming_ ? readStream() :
+                (init() && subset() && readVertices() && loadCells())) &&
+            loadBoundary();
+        return grdpProgressEnd(pRti_, finish(ret));
     }
 
 
 private:
 
-    // trim leading whitespace
-    static inline std::string &
-    ltrim(std::string &s)
+    // Populate a PWGM_ELEMDATA from the current line's tokens. The tokens
+    // must be in "Type Vertex1 ... VertexN Index" order.
+    inline bool
+    toksToElem(PWGM_ENUM_ELEMTYPE type, const PWP_UINT32 cnt,
+        PWGM_ELEMDATA &elem) const
     {
-        s.erase(s.begin(), std::find_if(s.begin(), s.end(),
-            std::not1(std::ptr_fun<int, int>(std::isspace))));
-        return s;
+        bool ret = (parser_->numToks() == (cnt + 2));
+        if (ret) {
+            elem.type = type;
+            elem.vertCnt = cnt;
+            for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
+                // Use ii+1 to skip past the "Type" token
+                if (!parser_->tokUInt(ii + 1, elem.index[ii])) {
+                    ret = false;
+                    break;
+                }
+            }
+        }
+        return ret;
     }
 
 
-    // trim trailing whitespace
-    static inline std::string &
-    rtrim(std::string &s)
+    // Reads the next non-empty, non-comment line with the parser engine.
+    // Returns false if EOF.
+    inline bool
+    readLine()
     {
-        s.erase(std::find_if(s.rbegin(), s.rend(),
-            std::not1(std::ptr_fun<int, int>(std::isspace))).base(), s.end());
-        return s;
+        return parser_->readLine();
     }
 
 
-    // trim leading and trailing whitespace
-    static inline std::string &
-    trim(std::string &s)
+    // Attempts to parse line as a "key=value" string into a key and value.
+    // Returns false if parsing fails. Returns true if key and value are set.
+    // The key and value are trimmed of all leading and trailing whitespoace.
+    static inline bool
+    splitKeyVal(const char *line, std::string &key, std::string &val)
     {
-        return ltrim(rtrim(s));
+        const char *eq = strchr(line, '=');
+        bool ret = (0 != eq);
+        if (ret) {
+            key.assign(line, eq);
+            trim(key);
+            val = eq + 1;
+            trim(val);
+        }
+        return ret && !key.empty();
     }
 
 
-    // Convert a char* of specified base to an integer value of type T.
-    template<typename T>
-    static inline bool
-    toInt(const char *str, T &val, const int base = 10)
+    // Send an error message to the application with optional detail text.
+    // The message is of the form: "msg" or "msg: 'detail'"
+    void
+    reportError(const char *msg, const std::string &detail)
     {
-        char* endptr = 0;
-        if (str && ('\0' != *str)) {
-            errno = 0;
-            val = static_cast<T>(strtol(str, &endptr, base));
-            if (0 != errno) {
-                endptr = 0;
-            }
+        std::ostringstream oss;
+        oss << msg;
+        if (!detail.empty()) {
+            oss << ": '" << detail << "'";
         }
-        return endptr && ('\0' == *endptr);
+        grdpSendErrorMsg(pRti_, oss.str().c_str(), 0);
     }
 
 
-    // Convert a std::string of specified base to an integer value of type T.
-    template<typename T>
-    static inline bool
-    toInt(const std::string &str, T &val, const int base = 10)
+    // Send an error message to the application with the current line as the
+    // detail text.
+    void
+    reportError(const char *msg)
     {
-        return toInt(str.c_str(), val, base);
+        reportError(msg, parser_->text());
     }
 
 
-    // Convert a char* to a floating point value of type T.
-    template<typename T>
-    static inline bool
-    toDbl(const char *str, T &val)
+    // Get the value of the named import attribute. Returns defVal if the
+    // attribute was not set by the application.
+    std::string
+    getAttr(const char *name, const char *defVal) const
     {
-        char* endptr = 0;
-        if (str && ('\0' != *str)) {
-            errno = 0;
-            val = strtod(str, &endptr);
-            if (0 != errno) {
-                endptr = 0;
-            }
-        }
-        return endptr && ('\0' == *endptr);
+        const char *val = 0;
+        return (PwModGetAttributeString(pRti_->model, name, &val) && val) ?
+            std::string(val) : std::string(defVal);
     }
 
 
-    // Convert a std::string to a floating point value of type T.
-    template<typename T>
-    static inline bool
-    toDbl(const std::string &str, T &val)
+    // Get the value of the named unsigned integer import attribute. Returns
+    // defVal if the attribute was not set by the application.
+    PWP_UINT32
+    getAttrUInt(const char *name, PWP_UINT32 defVal) const
     {
-        return toDbl(str.c_str(), val);
+        PWP_UINT32 val = defVal;
+        return PwModGetAttributeUINT32(pRti_->model, name, &val) ? val :
+            defVal;
     }
 
 
-    // Populate a PWGM_ELEMDATA from an array of std::string values. The array
-    // values must be in "Type Vertex1 ... VertexN Index" order.
-    static inline bool
-    toksToElem(const StringArray1 &toks, PWGM_ENUM_ELEMTYPE type,
-        const PWP_UINT32 cnt, PWGM_ELEMDATA &elem)
+    // Decide how the file is imported from its size, file system, compression
+    // and grid dimensionality, and from the core count and available memory.
+    // Small and 2D grids are imported with one thread and a small buffer.
+    // Large 3D grids use every core for boundary extraction and a large
+    // buffer. Parsing always uses one thread.
+    // Pipes are streamed. Compressed files are rejected unless
+    // ImportDecompress allows running their decompressor, and are then
+    // streamed. Other regular files, including those on a network file
+    // system, are read with positioning because streaming requires NDIME
+    // first and stages every cell in memory. Network files get a larger
+    // buffer. The ImportBackend, ImportThreads, ImportBufferSize and
+    // StagingMemoryLimit attributes override the planned values.
+    bool
+    plan()
     {
-        // toks MUST be in "Type Vertex1 ... VertexN Index" order.
-        bool ret = (toks.size() == (cnt + 2));
+        const char *path = pRti_->pReadInfo->fileDest;
+        startTime_ = Clock::now();
+        const bool regular = regularFileSize(path, fileSize_);
+        std::string fsName("pipe");
+        const FsKind fs = regular ? fileSystemOf(path, fsName) : FsUnknown;
+        PWP_UINT32 dimty = 0;
+        if (regular) {
+            // Reading ahead would consume the data of a pipe
+            peek(path, dimty);
+        }
+        const unsigned long long availMem = availableMemory();
+        const unsigned int cores = numCores();
+        const std::string backend = getAttr("ImportBackend", "Auto");
+        const char *why = "regular file";
+        bool ret = true;
+        PWP_BOOL decompress = PWP_FALSE;
+        if (compression_ && !(PwModGetAttributeBOOL(pRti_->model,
+                "ImportDecompress", &decompress) && decompress)) {
+            // Running an external tool must be asked for
+            std::string msg("File is ");
+            msg += compression_->name;
+            msg += " compressed. Set ImportDecompress to read it with";
+            reportError(msg.c_str(), compression_->command);
+            ret = false;
+        }
+        else if ("Stream" == backend) {
+            streaming_ = true;
+            why = "ImportBackend";
+        }
+        else if ("Seekable" == backend) {
+            why = "ImportBackend";
+            if (compression_) {
+                reportError("Compressed files can only be streamed", path);
+                ret = false;
+            }
+        }
+        else if ("Auto" != backend) {
+            reportError("Invalid ImportBackend value", backend);
+            ret = false;
+        }
+        else if (!regular) {
+            streaming_ = true;
+            why = "not a regular file";
+        }
+        else if (compression_) {
+            streaming_ = true;
+            why = "compressed";
+        }
+        else if (needsPositioning()) {
+            why = "subset or parser verification";
+        }
+
+        threads_ = getAttrUInt("ImportThreads", 0);
+        if (0 == threads_) {
+            // Only 3D grids have parallel work. Thread startup costs more
+            // than it saves on small files.
+            const unsigned long long ThreadBytes = 32ULL << 20;
+            threads_ = (2 == dimty) ? 1 : !regular ? cores :
+                PWP_UINT32(std::min(std::max(fileSize_ / ThreadBytes, 1ULL),
+                    (unsigned long long)cores));
+        }
+
+        bufSize_ = size_t(getAttrUInt("ImportBufferSize", 0)) << 10;
+        if (0 == bufSize_) {
+            const size_t SmallBuf = 64 << 10;
+            const size_t LargeBuf = 1 << 20;
+            const size_t NetworkBuf = 4 << 20;
+            bufSize_ = (FsNetwork == fs) ? NetworkBuf :
+                (!regular || compression_ || (fileSize_ >= (64ULL << 20))) ?
+                LargeBuf : SmallBuf;
+        }
+
+        // StagingMemoryLimit is in MB. A seekable import rescans the file
+        // instead of exceeding the limit, so bound it by the available
+        // memory. A streamed import cannot rescan so is left unlimited.
+        size_t stagingLimit = size_t(getAttrUInt("StagingMemoryLimit", 0)) <<
+            20;
+        if ((0 == stagingLimit) && !streaming_) {
+            stagingLimit = size_t(availMem / 2);
+        }
+        store_.setLimit(stagingLimit);
+
         if (ret) {
-            elem.type = type;
-            elem.vertCnt = cnt;
-            for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
-                // Use ii+1 to skip past the "Type" value in toks.at(0)
-                if (!toInt(toks.at(ii + 1), elem.index[ii])) {
-                    ret = false;
-                    break;
-                }
+            std::ostringstream oss;
+            oss << "Import plan: " << (streaming_ ? "Stream" : "Seekable") <<
+                " (" << why << "), " << threads_ <<
+                " boundary extraction threads, " << (bufSize_ >> 10) <<
+                " KB buffer, " <<
+                (stagingLimit ? std::to_string(stagingLimit >> 20) + " MB" :
+                    std::string("unlimited")) << " staging. File: ";
+            if (regular) {
+                oss << (fileSize_ >> 20) << " MB on " << fsName;
+            }
+            else {
+                oss << "pipe";
+            }
+            if (compression_) {
+                oss << ", " << compression_->name << " compressed";
             }
+            if (dimty) {
+                oss << ", NDIME= " << dimty;
+            }
+            oss << ". System: " << cores << " cores, ";
+            if (availMem) {
+                oss << (availMem >> 20) << " MB available";
+            }
+            else {
+                oss << "unknown memory available";
+            }
+            grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
         }
         return ret;
     }
 
 
-    // Reads the next non-empty, non-comment line into line_. Returns true if
-    // line_ contains data. Returns false if EOF.
+    // Read the start of the regular file at path to find its compression
+    // format. If it is not compressed, get the NDIME value if it is found
+    // near the start of the file. dimty is 0 if not found.
+    void
+    peek(const char *path, PWP_UINT32 &dimty)
+    {
+        PwpFile file;
+        if (file.open(path, pwpRead | pwpBinary)) {
+            char buf[16 * 1024];
+            const size_t len = fread(buf, 1, sizeof(buf) - 1, file.fp());
+            buf[len] = '\0';
+            for (size_t ii = 0; ii < SU2NumCompressions; ++ii) {
+                const SU2Compression &comp = SU2Compressions[ii];
+                if ((len >= comp.magicLen) &&
+                        (0 == memcmp(buf, comp.magic, comp.magicLen))) {
+                    compression_ = &comp;
+                    return;
+                }
+            }
+            // Only whole lines are checked
+            char *end = strrchr(buf, '\n');
+            if (end) {
+                *end = '\0';
+            }
+            std::string key;
+            std::string val;
+            for (char *line = buf; end && (0 == dimty); line = end + 1) {
+                end = strchr(line, '\n');
+                if (end) {
+                    *end = '\0';
+                }
+                if (('%' != *line) && splitKeyVal(line, key, val) &&
+                        ("NDIME" == key) && !toInt(val, dimty)) {
+                    dimty = 0;
+                }
+            }
+        }
+    }
+
+
+    // Returns true if an import attribute that requires file positioning is
+    // set.
     bool
-    readLine()
+    needsPositioning() const
     {
-        static const size_t BufSz = 1024;
-        char buf[BufSz];
-        bool ret = false;
-        while (fgets(buf, BufSz, in_.fp())) {
-            line_ = buf;
-            if (trim(line_).empty() || ('%' == line_.at(0))) {
-                // line_ is empty or comment - skip and get next
-                continue;
+        PWP_BOOL verify = PWP_FALSE;
+        return !getAttr("SubsetTypes", "").empty() ||
+            !getAttr("SubsetBox", "").empty() ||
+            !getAttr("SubsetMarkers", "").empty() ||
+            (PwModGetAttributeBOOL(pRti_->model, "ParserVerify", &verify) &&
+                verify);
+    }
+
+
+    // Open the grid file as planned. A compressed file is read from the
+    // output of its decompressor. If the file does not support positioning
+    // it is streamed.
+    bool
+    open()
+    {
+        const char *path = pRti_->pReadInfo->fileDest;
+        // IMPORTANT! MUST use pwpBinary when opening file to prevent platform
+        // EOL differences from breaking file position handling.
+        bool ret = compression_ ? openPipe() :
+            in_.open(path, pwpRead | pwpBinary);
+        if (!ret) {
+            reportError("Could not open file", path);
+        }
+        else {
+            FILE *fp = (compression_ ? pipe_ : in_.fp());
+            // Must be set before the first read
+            setvbuf(fp, 0, _IOFBF, bufSize_);
+            const std::string engine = getAttr("ParserEngine", "Legacy");
+            if (fast_.name() == engine) {
+                parser_ = &fast_;
+            }
+            else if (legacy_.name() != engine) {
+                reportError("Invalid ParserEngine value", engine);
+                ret = false;
+            }
+            parser_->setFile(fp);
+            const std::string boundary = getAttr("ExtractBoundary", "Never");
+            if ("Always" == boundary) {
+                boundary_ = BoundaryAlways;
+            }
+            else if ("NoMarkers" == boundary) {
+                boundary_ = BoundaryNoMarkers;
+            }
+            sysFILEPOS pos;
+            if (!streaming_ && !in_.getPos(pos)) {
+                if ("Seekable" == getAttr("ImportBackend", "Auto")) {
+                    reportError("File does not support positioning", path);
+                    ret = false;
+                }
+                streaming_ = true;
+            }
+            if (ret && streaming_ && (!getAttr("SubsetTypes", "").empty() ||
+                    !getAttr("SubsetBox", "").empty() ||
+                    !getAttr("SubsetMarkers", "").empty())) {
+                reportError("Subset import is not supported when streaming",
+                    path);
+                ret = false;
             }
-            ret = true;
-            break;
         }
         return ret;
     }
 
 
-    // Reads the next line and splits it into tokens (space delimited).
-    // Returns true if toks contains data. Returns false if EOF.
+    // Start the decompressor of the grid file and read its output. The
+    // command is run by the shell and found on the PATH.
     bool
-    readLineTokens(StringArray1 &toks)
+    openPipe()
     {
-        bool ret = readLine();
-        if (ret) {
-            toks.clear();
-            std::string lineBuf;
-            std::stringstream ss(line_);
-            while (ss >> lineBuf) {
-                // capture whitespace separated tokens
-                toks.push_back(lineBuf);
+#if defined(_WIN32)
+        reportError("Compressed files are not supported on this platform",
+            compression_->name);
+        return false;
+#else
+        // Quote the path for the shell
+        std::string cmd(compression_->command);
+        cmd += " -- '";
+        for (const char *p = pRti_->pReadInfo->fileDest; *p; ++p) {
+            if ('\'' == *p) {
+                cmd += "'\\''";
+            }
+            else {
+                cmd += *p;
             }
         }
-        return ret;
+        cmd += "'";
+        pipe_ = popen(cmd.c_str(), "r");
+        return 0 != pipe_;
+#endif
     }
 
 
-    // Attempts to parse line as a "key=value" string into a key and value.
-    // Returns false if parsing fails. Returns true if key and value are set.
-    // The key and value are trimmed of all leading and trailing whitespoace.
-    static inline bool
-    splitKeyVal(const std::string &line, std::string &key, std::string &val)
+    // Wait for the decompressor to exit. Returns its exit status or 0 if
+    // there is no decompressor.
+    int
+    closePipe()
     {
-        const size_t n = line.find('=');
-        bool ret = (std::string::npos != n);
-        if (ret) {
-            key = line.substr(0, n);
-            trim(key);
-            val = line.substr(n + 1);
-            trim(val);
+        int ret = 0;
+#if !defined(_WIN32)
+        if (pipe_) {
+            ret = pclose(pipe_);
+            pipe_ = 0;
         }
-        return ret && !key.empty();
+#endif
+        return ret;
     }
 
 
-    // Send an error message to the application with optional detail text.
-    // The message is of the form: "msg" or "msg: 'detail'"
-    void
-    reportError(const char *msg, const std::string &detail)
+    // Drain a pipe, close the decompressor and report its failure. If the
+    // import succeeded, report the time taken and the throughput.
+    bool
+    finish(bool ret)
     {
-        std::ostringstream oss;
-        oss << msg;
-        if (!detail.empty()) {
-            oss << ": '" << detail << "'";
+        // The import stops reading after the points, so read the rest of the
+        // data (the markers). Closing a pipe early would kill its writer, the
+        // decompressor before it checks the file's trailer or the program
+        // feeding a named pipe.
+        FILE *fp = pipe_ ? pipe_ : (streaming_ && (0 == fileSize_)) ?
+            in_.fp() : 0;
+        if (ret && fp) {
+            char buf[64 * 1024];
+            while (0 < fread(buf, 1, sizeof(buf), fp)) {
+            }
         }
-        grdpSendErrorMsg(pRti_, oss.str().c_str(), 0);
+        const int status = closePipe();
+#if !defined(_WIN32)
+        // A failed import may stop reading early which kills the decompressor.
+        // Only report that if it could not be run.
+        if ((0 != status) && (ret || (WIFEXITED(status) &&
+                (127 == WEXITSTATUS(status))))) {
+            reportError("Decompression failed", compression_->command);
+            ret = false;
+        }
+#else
+        (void)status;
+#endif
+        if (ret) {
+            const double secs = std::chrono::duration<double>(Clock::now() -
+                startTime_).count();
+            std::ostringstream oss;
+            oss.setf(std::ios::fixed);
+            oss.precision(2);
+            oss << "Imported " << (used_.size() ? used_.count() : nPoints_) <<
+                " points and " << nElems_ << " elements in " << secs << " s";
+            if ((0 < fileSize_) && (0.0 < secs)) {
+                // A compressed file's size is that of its compressed data
+                oss << " (" << (double(fileSize_) / double(1 << 20) / secs) <<
+                    " MB/s of " << (compression_ ? "compressed " : "") <<
+                    "file data)";
+            }
+            grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
+        }
+        return ret;
     }
 
 
-    // Send an error message to the application with the current line_ as the
-    // detail text.
-    void
-    reportError(const char *msg)
+    // If ParserVerify is set, parse the entire file with both the Legacy and
+    // Fast engines and compare their results. The file is read twice, side
+    // by side, so no grid data is held in memory. Every line must have the
+    // same text. Every token of the element, point and marker lines must
+    // convert to the same value. Reals are compared bitwise. The first
+    // divergence is reported as an error.
+    bool
+    verifyParsers()
     {
-        reportError(msg, line_);
+        if (!parserVerify()) {
+            return true;
+        }
+        if (streaming_) {
+            reportError("ParserVerify requires a file that supports "
+                "positioning", pRti_->pReadInfo->fileDest);
+            return false;
+        }
+        PwpFile files[2];
+        SU2LegacyParser legacy;
+        SU2FastParser fast;
+        SU2Parser *engines[2] = { &legacy, &fast };
+        for (int ii = 0; ii < 2; ++ii) {
+            if (!files[ii].open(pRti_->pReadInfo->fileDest,
+                    pwpRead | pwpBinary)) {
+                reportError("Could not open file", pRti_->pReadInfo->fileDest);
+                return false;
+            }
+            engines[ii]->setFile(files[ii].fp());
+        }
+        const SU2Parser &a = legacy;
+        const SU2Parser &b = fast;
+        enum { KeyLines, IntLines, RealLines } lineType = KeyLines;
+        PWP_UINT32 numLeft = 0;     // lines left in the current block
+        PWP_UINT64 numChecked[3] = { 0, 0, 0 };
+        std::string key;
+        std::string val;
+        std::ostringstream diff;    // describes the first divergence
+        bool ret = grdpProgressBeginStep(pRti_, 1);
+        while (ret && diff.str().empty()) {
+            const bool haveA = legacy.readLine();
+            const bool haveB = fast.readLine();
+            if (haveA != haveB) {
+                diff << (haveA ? b.name() : a.name()) << " reached EOF";
+                break;
+            }
+            else if (!haveA) {
+                break;
+            }
+            else if (0 != strcmp(a.text(), b.text())) {
+                diff << "line text differs";
+            }
+            else if (a.numToks() != b.numToks()) {
+                diff << "token count " << a.numToks() << " vs " <<
+                    b.numToks();
+            }
+            else if (0 < numLeft) {
+                // A line of element or marker (IntLines) or point (RealLines)
+                // data. The last token of a point line is its index.
+                for (size_t ii = 0; ii < a.numToks(); ++ii) {
+                    const bool isInt = (IntLines == lineType) ||
+                        (ii + 1 == a.numToks());
+                    PWP_UINT32 intA = 0;
+                    PWP_UINT32 intB = 0;
+                    PWP_REAL realA = 0.0;
+                    PWP_REAL realB = 0.0;
+                    const bool okA = isInt ? a.tokUInt(ii, intA) :
+                        a.tokReal(ii, realA);
+                    const bool okB = isInt ? b.tokUInt(ii, intB) :
+                        b.tokReal(ii, realB);
+                    if ((okA != okB) || (intA != intB) ||
+                            (0 != memcmp(&realA, &realB, sizeof(realA)))) {
+                        diff << "token " << ii << " converts to ";
+                        if (isInt) {
+                            diff << intA << " vs " << intB;
+                        }
+                        else {
+                            diff.precision(17);
+                            diff << realA << " vs " << realB;
+                        }
+                        break;
+                    }
+                }
+                ++numChecked[lineType];
+                if (0 == --numLeft) {
+                    lineType = KeyLines;
+                }
+            }
+            else if (splitKeyVal(a.text(), key, val)) {
+                if (("NELEM" == key) || ("MARKER_ELEMS" == key)) {
+                    lineType = IntLines;
+                }
+                else if ("NPOIN" == key) {
+                    lineType = RealLines;
+                }
+                if ((KeyLines != lineType) && !toInt(val, numLeft)) {
+                    reportError("Invalid block size", a.text());
+                    ret = false;
+                }
+                if (0 == numLeft) {
+                    lineType = KeyLines;
+                }
+            }
+        }
+        if (ret && !diff.str().empty()) {
+            std::ostringstream oss;
+            oss << "Parser divergence at line " << a.lineNum() << ": " <<
+                a.name() << " vs " << b.name() << " " << diff.str() <<
+                ": '" << a.text() << "'";
+            grdpSendErrorMsg(pRti_, oss.str().c_str(), 0);
+            ret = false;
+        }
+        else if (ret) {
+            std::ostringstream oss;
+            oss << "Parser verification passed: " << a.name() << " and " <<
+                b.name() << " agree on " << numChecked[IntLines] <<
+                " element and marker lines and " << numChecked[RealLines] <<
+                " point lines";
+            grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
+        }
+        return grdpProgressEndStep(pRti_) && ret;
     }
 
 
@@ -265,19 +1947,14 @@ private:
     init()
     {
         bool ret = false;
-        // IMPORTANT! MUST use pwpBinary when opening file to prevent platform
-        // EOL differences from breaking file position handling.
-        if (!in_.open(pRti_->pReadInfo->fileDest, pwpRead | pwpBinary)) {
-            reportError("Could not open file", pRti_->pReadInfo->fileDest);
-        }
-        else if (grdpProgressBeginStep(pRti_, 3)) {
+        if (grdpProgressBeginStep(pRti_, 3)) {
             bool foundNDIME = false;
             bool foundNELEM = false;
             bool foundNPOIN = false;
             std::string key;
             std::string val;
             while (readLine()) {
-                if (!splitKeyVal(line_, key, val)) {
+                if (!splitKeyVal(parser_->text(), key, val)) {
                     // not a "key=value" pair
                     continue;
                 }
@@ -323,7 +2000,7 @@ private:
                     // We have everything we need - we can stop scanning.
                     // Caveat: Will not detect if values are erroneously duped
                     //         later in file.
-                    ret = true;
+                    ret = in_.getPos(posTailData_);
                     break;
                 }
                 if (!grdpProgressIncr(pRti_)) {
@@ -332,7 +2009,7 @@ private:
             }
         }
         return grdpProgressEndStep(pRti_) && ret &&
-            (gridIs3D_ ? getCellCounts3() : getCellCounts2());
+            in_.setPos(posNELEMData_) && stageCells();
     }
 
 
@@ -355,177 +2032,360 @@ private:
     }
 
 
-    // Extract the number of grid points from str and cache the current file
-    // position.
-    bool
-    parseNPOIN(const std::string &str)
+    // Extract the number of grid points from str and cache the current file
+    // position.
+    bool
+    parseNPOIN(const std::string &str)
+    {
+        return toInt(str, nPoints_) && in_.getPos(posNPOINData_);
+    }
+
+
+    // Read the next point line into vert.
+    bool
+    readPoint(PWGM_VERTDATA &vert)
+    {
+        const size_t TokCnt = (gridIs3D_ ? 4 : 3);
+        const SU2Parser &toks = *parser_;
+        PWP_UINT32 ndx = 0;
+        bool ret = false;
+        if (!readLine()) {
+            reportError("Unexpected EOF while reading point");
+        }
+        else if (TokCnt != toks.numToks()) {
+            reportError("Unexpected number of point tokens");
+        }
+        else {
+            if (gridIs3D_) {
+                // Expecting "x y z index"
+                ret = toks.tokReal(0, vert.x) && toks.tokReal(1, vert.y) &&
+                    toks.tokReal(2, vert.z) && toks.tokUInt(3, ndx);
+            }
+            else {
+                // Expecting "x y index"
+                ret = toks.tokReal(0, vert.x) && toks.tokReal(1, vert.y) &&
+                    toks.tokUInt(2, ndx);
+            }
+            if (!ret) {
+                reportError("Could not read point");
+            }
+        }
+        return ret;
+    }
+
+
+    // Extract grid point data from the file and populate an uns vertex list.
+    // If a subset is being imported, only the points in used_ are loaded.
+    bool
+    readVertices()
+    {
+        parser_->clear();
+        const bool isSubset = (0 != used_.size());
+        // Create the vertex list
+        hVL_ = PwModCreateUnsVertexList(pRti_->model);
+        // Allocate room for the vertices and set the file's position to the
+        // begining of the vertex data.
+        bool ret = PWGM_HVERTEXLIST_ISVALID(hVL_) &&
+            PwVlstAllocate(hVL_, isSubset ? used_.count() : nPoints_) &&
+            (streaming_ || in_.setPos(posNPOINData_));
+        if (ret) {
+            PWGM_VERTDATA vert = { 0.0 };
+            PWP_UINT32 vertCount = 0;
+            while (vertCount < nPoints_) {
+                if (!readPoint(vert)) {
+                    ret = false;
+                    break;
+                }
+                else if (isSubset && !used_.test(vertCount)) {
+                    // not in the subset
+                }
+                else if (!PwVlstSetXYZData(hVL_, isSubset ?
+                        used_.rank(vertCount) : vertCount, vert)) {
+                    reportError("Could set vertex list data");
+                    ret = false;
+                    break;
+                }
+                ++vertCount;
+            }
+        }
+        else {
+            reportError("Could create vertex list");
+        }
+        return ret;
+    }
+
+
+    // Split a list of names or values delimited by whitespace, '|' or ','.
+    static void
+    splitList(const std::string &str, StringArray1 &items)
+    {
+        items.clear();
+        std::string item;
+        for (size_t ii = 0; ii <= str.size(); ++ii) {
+            const char c = (ii < str.size()) ? str[ii] : ' ';
+            if (isspace(c) || ('|' == c) || (',' == c)) {
+                if (!item.empty()) {
+                    items.push_back(item);
+                    item.clear();
+                }
+            }
+            else {
+                item += c;
+            }
+        }
+    }
+
+
+    // Map an element type name as used in ValidElements to its SU2 type.
+    static bool
+    nameToSU2Type(const std::string &name, PWP_UINT32 &su2Type)
     {
-        return toInt(str, nPoints_) && in_.getPos(posNPOINData_);
+        for (size_t ii = 0; ii < SU2NumElemTypes; ++ii) {
+            if (name == SU2ElemInfos[ii].name) {
+                su2Type = SU2ElemInfos[ii].type;
+                return true;
+            }
+        }
+        return false;
     }
 
 
-    // Extract the element counts from a 2D grid file.
+    // Reduce the staged elements to the subset selected by the SubsetTypes,
+    // SubsetBox and SubsetMarkers import attributes. A cell is kept if it
+    // passes all of the given filters. The points used by the kept cells are
+    // set in used_ and are renumbered as they are loaded. Does nothing if no
+    // subset was requested.
     bool
-    getCellCounts2()
+    subset()
     {
-        PWP_UINT32 cellCount = 0;
-        line_.clear();
-        // Set file position to beginning of element data
-        bool ret = in_.setPos(posNELEMData_);
-        if (grdpProgressBeginStep(pRti_, nElems_) && ret) {
-            StringArray1 toks;
-            PWP_UINT32 elemType;
-            while (ret && (cellCount++ < nElems_)) {
-                // For each line, expecting "Type Vertex1 ... VertexN Index"
-                if (!readLineTokens(toks)) {
-                    reportError("Unexpected EOF while reading 2D counts");
-                    ret = false;
-                    break;
-                }
+        const std::string types = getAttr("SubsetTypes", "");
+        const std::string box = getAttr("SubsetBox", "");
+        const std::string markers = getAttr("SubsetMarkers", "");
+        if (types.empty() && box.empty() && markers.empty()) {
+            return true;
+        }
+        if (nElems_ != store_.size()) {
+            reportError("Subset import requires all element data to be staged. "
+                "Increase StagingMemoryLimit", std::string());
+            return false;
+        }
 
-                if (!toInt(toks.at(0), elemType)) {
-                    reportError("Could not read 2D count type");
-                    ret = false;
-                    break;
-                }
+        // Element types to keep, indexed by SU2 type
+        std::vector<bool> keepType(SU2Pyramid + 1, types.empty());
+        StringArray1 items;
+        PWP_UINT32 su2Type;
+        splitList(types, items);
+        for (size_t ii = 0; ii < items.size(); ++ii) {
+            // Only the cell types of the grid's dimensionality are staged
+            if (!nameToSU2Type(items[ii], su2Type) ||
+                    (su2ElemInfo(su2Type)->dimty != (gridIs3D_ ? 3U : 2U))) {
+                reportError("Invalid SubsetTypes element type", items[ii]);
+                return false;
+            }
+            keepType[su2Type] = true;
+        }
 
-                switch (elemType) {
-                case SU2Tri:
-                    ++PWGM_ECNT_Tri(nElemTypes_);
-                    break;
-                case SU2Quad:
-                    ++PWGM_ECNT_Quad(nElemTypes_);
-                    break;
-                default:
-                    reportError("Unexpected 2D count type");
+        VertexMask inBox;
+        VertexMask nearMarkers;
+        bool ret = (box.empty() || markBox(box, inBox)) &&
+            (markers.empty() || markNearMarkers(markers, nearMarkers));
+        if (ret) {
+            // Both stores are held until the swap, so kept may only use what
+            // store_ left of the limit. A limit of 0 would be unlimited.
+            SU2ElemStore kept;
+            const size_t limit = store_.limit();
+            kept.setLimit(limit ? std::max(limit - store_.bytes(), size_t(1)) :
+                0);
+            SU2ElemStore::Cursor cur(store_);
+            PWP_UINT32 verts[SU2MaxVertCnt];
+            PWP_UINT32 cnt;
+            PWGM_ENUM_ELEMTYPE type = PWGM_ELEMTYPE_SIZE;
+            used_.resize(nPoints_);
+            nElemTypes_ = ZeroCounts;
+            while (ret && cur.next(su2Type, verts, cnt)) {
+                if (!keepType[su2Type] ||
+                        (inBox.size() && !inBox.testAny(verts, cnt)) ||
+                        (nearMarkers.size() &&
+                            !nearMarkers.testAny(verts, cnt))) {
+                    continue;
+                }
+                if (!kept.push(su2Type, verts)) {
+                    reportError("Element staging memory limit exceeded",
+                        std::string());
                     ret = false;
                     break;
                 }
-                if (!grdpProgressIncr(pRti_)) {
-                    ret = false;
+                for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
+                    used_.set(verts[ii]);
                 }
+                su2TypeToElem(su2Type, type, cnt);
+                ++nElemTypes_.count[type];
+            }
+            if (ret) {
+                used_.buildRank();
+                std::ostringstream oss;
+                oss << "Subset kept " << kept.size() << " of " << nElems_ <<
+                    " elements and " << used_.count() << " of " << nPoints_ <<
+                    " points";
+                grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
+                nElems_ = PWP_UINT32(kept.size());
+                store_.swap(kept);
+                store_.setLimit(limit);
             }
         }
-        return grdpProgressEndStep(pRti_) && ret;
+        return ret;
     }
 
 
-    // Extract the element counts from a 3D grid file.
+    // Set the points inside the bounding box given as "xmin ymin zmin xmax
+    // ymax zmax". A 2D box may also be given as "xmin ymin xmax ymax".
     bool
-    getCellCounts3()
+    markBox(const std::string &box, VertexMask &mask)
     {
-        PWP_UINT32 cellCount = 0;
-        line_.clear();
-        bool ret = in_.setPos(posNELEMData_);
-        if (grdpProgressBeginStep(pRti_, nElems_) && ret) {
-            StringArray1 toks;
-            PWP_UINT32 elemType;
-            while (ret && (cellCount++ < nElems_)) {
-                // For each line, expecting "Type Vertex1 ... VertexN Index"
-                if (!readLineTokens(toks)) {
-                    reportError("Unexpected EOF while reading 3D counts");
+        StringArray1 items;
+        splitList(box, items);
+        const size_t dimty = (!gridIs3D_ && (4 == items.size())) ? 2 : 3;
+        PWP_REAL lo[3] = { 0.0 };
+        PWP_REAL hi[3] = { 0.0 };
+        bool ret = (2 * dimty == items.size());
+        for (size_t ii = 0; ret && (ii < dimty); ++ii) {
+            ret = toDbl(items[ii], lo[ii]) && toDbl(items[ii + dimty], hi[ii]);
+        }
+        if (!ret) {
+            reportError("Invalid SubsetBox value", box);
+        }
+        else if (!in_.setPos(posNPOINData_)) {
+            ret = false;
+        }
+        else {
+            mask.resize(nPoints_);
+            PWGM_VERTDATA vert = { 0.0 };
+            for (PWP_UINT32 ii = 0; ii < nPoints_; ++ii) {
+                if (!readPoint(vert)) {
                     ret = false;
                     break;
                 }
-
-                if (!toInt(toks.at(0), elemType)) {
-                    reportError("Could not read 3D count type");
-                    ret = false;
-                    break;
+                if ((vert.x >= lo[0]) && (vert.x <= hi[0]) &&
+                        (vert.y >= lo[1]) && (vert.y <= hi[1]) &&
+                        ((2 == dimty) || ((vert.z >= lo[2]) &&
+                            (vert.z <= hi[2])))) {
+                    mask.set(ii);
                 }
+            }
+        }
+        return ret;
+    }
 
-                switch (elemType) {
-                case SU2Tet:
-                    ++PWGM_ECNT_Tet(nElemTypes_);
-                    break;
-                case SU2Pyramid:
-                    ++PWGM_ECNT_Pyramid(nElemTypes_);
-                    break;
-                case SU2Wedge:
-                    ++PWGM_ECNT_Wedge(nElemTypes_);
-                    break;
-                case SU2Hex:
-                    ++PWGM_ECNT_Hex(nElemTypes_);
-                    break;
-                default:
-                    reportError("Unexpected 3D count type");
-                    ret = false;
-                    break;
-                }
-                if (!grdpProgressIncr(pRti_)) {
-                    ret = false;
+
+    // Set the points within SubsetLayers cell layers of the named markers.
+    bool
+    markNearMarkers(const std::string &markers, VertexMask &mask)
+    {
+        StringArray1 names;
+        splitList(markers, names);
+        bool ret = scanMarkers(names, mask);
+        // The marker points are layer 1. Each additional layer adds the points
+        // of all cells that touch the previous layer.
+        const PWP_UINT32 numLayers = getAttrUInt("SubsetLayers", 1);
+        for (PWP_UINT32 layer = 1; ret && (layer < numLayers); ++layer) {
+            VertexMask next(mask);
+            SU2ElemStore::Cursor cur(store_);
+            PWP_UINT32 su2Type;
+            PWP_UINT32 verts[SU2MaxVertCnt];
+            PWP_UINT32 cnt;
+            while (cur.next(su2Type, verts, cnt)) {
+                if (mask.testAny(verts, cnt)) {
+                    for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
+                        next.set(verts[ii]);
+                    }
                 }
             }
+            mask.swap(next);
         }
-        return grdpProgressEndStep(pRti_) && ret;
+        return ret;
     }
 
 
-    // Extract grid point data from the file and populate an uns vertex list.
+    // Set the points used by the elements of the named markers. The markers
+    // follow the grid's element and point data.
     bool
-    readVertices()
+    scanMarkers(const StringArray1 &names, VertexMask &mask)
     {
-        line_.clear();
-        // Create the vertex list
-        hVL_ = PwModCreateUnsVertexList(pRti_->model);
-        // Allocate room for the nPoints_ vertices and set the file's position
-        // to the begining of the vertex data.
-        bool ret = PWGM_HVERTEXLIST_ISVALID(hVL_) &&
-            PwVlstAllocate(hVL_, nPoints_) && in_.setPos(posNPOINData_);
-        if (ret) {
-            const size_t TokCnt = (gridIs3D_ ? 4 : 3);
-            PWGM_VERTDATA vert = { 0.0 };
-            StringArray1 toks;
-            PWP_UINT32 vertCount = 0;
-            PWP_UINT32 ndx = 0;
-            while (vertCount < nPoints_) {
-                if (!readLineTokens(toks)) {
-                    reportError("Unexpected EOF while reading point");
-                    ret = false;
-                    break;
+        mask.resize(nPoints_);
+        parser_->clear();
+        std::vector<bool> found(names.size(), false);
+        bool ret = in_.setPos(posTailData_);
+        bool inMarker = false;
+        std::string key;
+        std::string val;
+        while (ret && readLine()) {
+            if (!splitKeyVal(parser_->text(), key, val)) {
+                continue;
+            }
+            if ("MARKER_TAG" == key) {
+                const StringArray1::const_iterator it =
+                    std::find(names.begin(), names.end(), val);
+                inMarker = (names.end() != it);
+                if (inMarker) {
+                    found[it - names.begin()] = true;
                 }
-
-                if (TokCnt != toks.size()) {
-                    reportError("Unexpected number of point tokens");
+            }
+            else if (("MARKER_ELEMS" == key) && inMarker) {
+                PWP_UINT32 nMarkElems = 0;
+                if (!toInt(val, nMarkElems)) {
+                    reportError("Invalid MARKER_ELEMS value");
                     ret = false;
-                    break;
-                }
-
-                if (gridIs3D_) {
-                    // Expecting "x y z index"
-                    ret = toDbl(toks[0], vert.x) && toDbl(toks[1], vert.y) &&
-                        toDbl(toks[2], vert.z) && toInt(toks[3], ndx);
                 }
-                else {
-                    // Expecting "x y index"
-                    ret = toDbl(toks[0], vert.x) && toDbl(toks[1], vert.y) &&
-                        toInt(toks[2], ndx);
+                for (PWP_UINT32 ii = 0; ret && (ii < nMarkElems); ++ii) {
+                    ret = readMarkerElem(mask);
                 }
+                inMarker = false;
+            }
+        }
+        for (size_t ii = 0; ret && (ii < names.size()); ++ii) {
+            if (!found[ii]) {
+                reportError("Marker not found", names[ii]);
+                ret = false;
+            }
+        }
+        return ret;
+    }
 
-                if (!ret) {
-                    reportError("Could not read point");
-                    break;
-                }
-                else if (!PwVlstSetXYZData(hVL_, vertCount++, vert)) {
-                    reportError("Could set vertex list data");
-                    ret = false;
-                    break;
-                }
+
+    // Read a "Type Vertex1 ... VertexN" marker element and set its points in
+    // mask.
+    bool
+    readMarkerElem(VertexMask &mask)
+    {
+        const SU2Parser &toks = *parser_;
+        PWP_UINT32 elemType;
+        PWP_UINT32 vert;
+        const SU2ElemInfo *info = 0;
+        bool ret = readLine() && toks.tokUInt(0, elemType) &&
+            (0 != (info = su2ElemInfo(elemType))) && (info->dimty < 3);
+        const PWP_UINT32 cnt = ret ? info->vertCnt : 0;
+        ret = ret && (toks.numToks() > cnt);
+        for (PWP_UINT32 ii = 1; ret && (ii <= cnt); ++ii) {
+            ret = toks.tokUInt(ii, vert) && (vert < nPoints_);
+            if (ret) {
+                mask.set(vert);
             }
         }
-        else {
-            reportError("Could create vertex list");
+        if (!ret) {
+            reportError("Invalid marker element");
         }
         return ret;
     }
 
 
-    // Load all elements in the grid file
+    // Load all elements in the grid file. The staged elements are used if
+    // all of them fit in store_.
     bool
     loadCells()
     {
-        line_.clear();
-        return gridIs3D_ ? loadCells3() : loadCells2();
+        parser_->clear();
+        return (nElems_ == store_.size()) ? loadStagedCells() :
+            (gridIs3D_ ? loadCells3() : loadCells2());
     }
 
 
@@ -542,19 +2402,18 @@ private:
             PwUnsDomAllocateElementCounts(hDom, nElemTypes_) &&
             in_.setPos(posNELEMData_);
         if (ret) {
-            StringArray1 toks;
             PWGM_ELEMDATA elem;
             PWP_UINT32 ndx = 0;
             PWP_UINT32 elemType;
             while (ret && (ndx < nElems_)) {
                 // For each line, expecting "Type Vertex1 ... VertexN Index"
-                if (!readLineTokens(toks)) {
+                if (!readLine()) {
                     reportError("Unexpected EOF while reading 2D element");
                     ret = false;
                     break;
                 }
 
-                if (!toInt(toks.at(0), elemType)) {
+                if (!parser_->tokUInt(0, elemType)) {
                     reportError("Could not read 2D element type");
                     ret = false;
                     break;
@@ -562,13 +2421,13 @@ private:
 
                 switch (elemType) {
                 case SU2Tri:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_TRI, 3, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_TRI, 3, elem)) {
                         reportError("Invalid tri element connectivity");
                         ret = false;
                     }
                     break;
                 case SU2Quad:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_QUAD, 4, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_QUAD, 4, elem)) {
                         reportError("Invalid quad element connectivity");
                         ret = false;
                     }
@@ -613,19 +2472,18 @@ private:
             PwUnsBlkAllocateElementCounts(hBlk, nElemTypes_) &&
             in_.setPos(posNELEMData_);
         if (ret) {
-            StringArray1 toks;
             PWGM_ELEMDATA elem;
             PWP_UINT32 ndx = 0;
             PWP_UINT32 elemType;
             while (ret && (ndx < nElems_)) {
                 // For each line, expecting "Type Vertex1 ... VertexN Index"
-                if (!readLineTokens(toks)) {
+                if (!readLine()) {
                     reportError("Unexpected EOF while reading 3D element");
                     ret = false;
                     break;
                 }
 
-                if (!toInt(toks.at(0), elemType)) {
+                if (!parser_->tokUInt(0, elemType)) {
                     reportError("Could not read 3D element type");
                     ret = false;
                     break;
@@ -633,25 +2491,25 @@ private:
 
                 switch (elemType) {
                 case SU2Tet:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_TET, 4, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_TET, 4, elem)) {
                         reportError("Invalid tet element connectivity");
                         ret = false;
                     }
                     break;
                 case SU2Pyramid:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_PYRAMID, 5, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_PYRAMID, 5, elem)) {
                         reportError("Invalid pyramid element connectivity");
                         ret = false;
                     }
                     break;
                 case SU2Wedge:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_WEDGE, 6, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_WEDGE, 6, elem)) {
                         reportError("Invalid prism element connectivity");
                         ret = false;
                     }
                     break;
                 case SU2Hex:
-                    if (!toksToElem(toks, PWGM_ELEMTYPE_HEX, 8, elem)) {
+                    if (!toksToElem(PWGM_ELEMTYPE_HEX, 8, elem)) {
                         reportError("Invalid hex element connectivity");
                         ret = false;
                     }
@@ -682,6 +2540,362 @@ private:
         return grdpProgressEndStep(pRti_) && ret;
     }
 
+    // Map an SU2 element type to its grid model type and vertex count. Returns
+    // false if su2Type is not valid for the grid's dimensionality.
+    bool
+    su2TypeToElem(PWP_UINT32 su2Type, PWGM_ENUM_ELEMTYPE &type,
+        PWP_UINT32 &cnt) const
+    {
+        const SU2ElemInfo *info = su2ElemInfo(su2Type);
+        bool ret = (0 != info) && ((gridIs3D_ ? 3U : 2U) == info->dimty);
+        if (ret) {
+            cnt = info->vertCnt;
+            switch (su2Type) {
+            case SU2Tri:
+                type = PWGM_ELEMTYPE_TRI;
+                break;
+            case SU2Quad:
+                type = PWGM_ELEMTYPE_QUAD;
+                break;
+            case SU2Tet:
+                type = PWGM_ELEMTYPE_TET;
+                break;
+            case SU2Pyramid:
+                type = PWGM_ELEMTYPE_PYRAMID;
+                break;
+            case SU2Wedge:
+                type = PWGM_ELEMTYPE_WEDGE;
+                break;
+            case SU2Hex:
+                type = PWGM_ELEMTYPE_HEX;
+                break;
+            }
+        }
+        return ret;
+    }
+
+
+    // Import the grid in a single forward-only pass. No file positioning is
+    // used, so the grid can be read from a pipe as it is being written. The
+    // element counts are not known until the entire NELEM block is read, so
+    // the connectivity is staged in store_ and loaded after the vertices.
+    bool
+    readStream()
+    {
+        bool ret = grdpProgressBeginStep(pRti_, 3);
+        bool foundNDIME = false;
+        bool foundNELEM = false;
+        bool foundNPOIN = false;
+        std::string key;
+        std::string val;
+        while (ret && !(foundNELEM && foundNPOIN) && readLine()) {
+            if (!splitKeyVal(parser_->text(), key, val)) {
+                // not a "key=value" pair
+                continue;
+            }
+            if ("NDIME" == key) {
+                if (foundNDIME) {
+                    reportError("Duplicate NDIME value");
+                    ret = false;
+                }
+                else if (!parseNDIMEVal(val)) {
+                    reportError("Invalid NDIME value");
+                    ret = false;
+                }
+                foundNDIME = true;
+            }
+            else if ("NELEM" == key) {
+                if (!foundNDIME) {
+                    reportError("NDIME must precede NELEM when streaming");
+                    ret = false;
+                }
+                else if (foundNELEM) {
+                    reportError("Duplicate NELEM value");
+                    ret = false;
+                }
+                else if (!toInt(val, nElems_)) {
+                    reportError("Invalid NELEM value");
+                    ret = false;
+                }
+                else {
+                    ret = grdpProgressEndStep(pRti_) && stageCells() &&
+                        grdpProgressBeginStep(pRti_, 1);
+                }
+                foundNELEM = true;
+            }
+            else if ("NPOIN" == key) {
+                if (!foundNDIME) {
+                    reportError("NDIME must precede NPOIN when streaming");
+                    ret = false;
+                }
+                else if (foundNPOIN) {
+                    reportError("Duplicate NPOIN value");
+                    ret = false;
+                }
+                else if (!toInt(val, nPoints_)) {
+                    reportError("Invalid NPOIN value");
+                    ret = false;
+                }
+                else {
+                    ret = readVertices();
+                }
+                foundNPOIN = true;
+            }
+        }
+        if (ret && !(foundNELEM && foundNPOIN)) {
+            reportError("Unexpected EOF while streaming grid", std::string());
+            ret = false;
+        }
+        return grdpProgressEndStep(pRti_) && ret && loadStagedCells();
+    }
+
+
+    // Read the NELEM block and accumulate the element counts. The elements
+    // are staged in store_ so the block is parsed only once. If store_ hits
+    // its memory limit it is released and loadCells() will rescan the file,
+    // unless streaming where this is an error.
+    bool
+    stageCells()
+    {
+        store_.clear();
+        bool staging = true;
+        bool ret = grdpProgressBeginStep(pRti_, nElems_);
+        const SU2Parser &toks = *parser_;
+        PWP_UINT32 elemType;
+        PWGM_ENUM_ELEMTYPE type = PWGM_ELEMTYPE_SIZE;
+        PWP_UINT32 cnt;
+        PWP_UINT32 verts[SU2MaxVertCnt];
+        PWP_UINT32 cellCount = 0;
+        while (ret && (cellCount++ < nElems_)) {
+            // For each line, expecting "Type Vertex1 ... VertexN Index"
+            if (!readLine()) {
+                reportError("Unexpected EOF while reading element");
+                ret = false;
+                break;
+            }
+
+            if (!toks.tokUInt(0, elemType)) {
+                reportError("Could not read element type");
+                ret = false;
+                break;
+            }
+
+            if (!su2TypeToElem(elemType, type, cnt)) {
+                reportError("Unexpected element type");
+                ret = false;
+                break;
+            }
+            ++nElemTypes_.count[type];
+
+            if (!staging) {
+                // only counting
+            }
+            else if (toks.numToks() != (cnt + 2)) {
+                reportError("Invalid element connectivity");
+                ret = false;
+                break;
+            }
+            else {
+                for (PWP_UINT32 ii = 0; ii < cnt; ++ii) {
+                    // nPoints_ is 0 until NPOIN is read when streaming
+                    if (!toks.tokUInt(ii + 1, verts[ii]) ||
+                            ((!streaming_ || (0 < nPoints_)) &&
+                                (verts[ii] >= nPoints_))) {
+                        reportError("Invalid element connectivity");
+                        ret = false;
+                        break;
+                    }
+                }
+                if (ret && !store_.push(elemType, verts)) {
+                    if (streaming_) {
+                        reportError("Element staging memory limit exceeded");
+                        ret = false;
+                        break;
+                    }
+                    grdpSendWarningMsg(pRti_, "Element staging memory limit "
+                        "exceeded. Element data will be read twice.", 0);
+                    store_.clear();
+                    staging = false;
+                }
+            }
+
+            if (ret && !grdpProgressIncr(pRti_)) {
+                ret = false;
+            }
+        }
+        if (ret && staging) {
+            std::ostringstream oss;
+            oss << "Staged " << store_.size() << " elements in " <<
+                (store_.bytes() >> 10) << " KB";
+            grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
+        }
+        return grdpProgressEndStep(pRti_) && ret;
+    }
+
+
+    // Load all elements held in store_ into a block (3D) or domain (2D).
+    bool
+    loadStagedCells()
+    {
+        PWGM_HBLOCK hBlk;
+        PWGM_HDOMAIN hDom;
+        bool ret = grdpProgressBeginStep(pRti_, nElems_);
+        if (gridIs3D_) {
+            hBlk = PwVlstCreateUnsBlock(hVL_);
+            ret = ret && PWGM_HBLOCK_ISVALID(hBlk) &&
+                PwUnsBlkAllocateElementCounts(hBlk, nElemTypes_);
+        }
+        else {
+            hDom = PwVlstCreateUnsDomain(hVL_);
+            ret = ret && PWGM_HDOMAIN_ISVALID(hDom) &&
+                PwUnsDomAllocateElementCounts(hDom, nElemTypes_);
+        }
+        if (ret) {
+            SU2ElemStore::Cursor cur(store_);
+            PWGM_ELEMDATA elem;
+            PWP_UINT32 elemType;
+            PWP_UINT32 ndx = 0;
+            while (ret && cur.next(elemType, elem.index, elem.vertCnt)) {
+                // store_ only holds types accepted by stageCells()
+                su2TypeToElem(elemType, elem.type, elem.vertCnt);
+                for (PWP_UINT32 ii = 0; used_.size() && (ii < elem.vertCnt);
+                        ++ii) {
+                    elem.index[ii] = used_.rank(elem.index[ii]);
+                }
+                if (gridIs3D_ ? !PwUnsBlkSetElement(hBlk, ndx, &elem) :
+                        !PwUnsDomSetElement(hDom, ndx, &elem)) {
+                    reportError("Could not set element data", std::string());
+                    ret = false;
+                }
+                else if (!grdpProgressIncr(pRti_)) {
+                    ret = false;
+                }
+                ++ndx;
+            }
+        }
+        else {
+            reportError("Could create element entity", std::string());
+        }
+        if (BoundaryNever == boundary_) {
+            store_.clear();
+        }
+        return grdpProgressEndStep(pRti_) && ret;
+    }
+
+
+    // Returns true if the file has a marker with at least one element. The
+    // markers follow the grid's element and point data.
+    bool
+    hasMarkers()
+    {
+        parser_->clear();
+        bool ret = false;
+        if (streaming_ || in_.setPos(posTailData_)) {
+            std::string key;
+            std::string val;
+            PWP_UINT32 nMarkElems = 0;
+            while (!ret && readLine()) {
+                ret = splitKeyVal(parser_->text(), key, val) &&
+                    ("MARKER_ELEMS" == key) && toInt(val, nMarkElems) &&
+                    (0 < nMarkElems);
+            }
+        }
+        return ret;
+    }
+
+
+    // Derive the exterior boundary of the 3D cells and load it as a domain
+    // of tri and quad elements. Controlled by the ExtractBoundary attribute.
+    bool
+    loadBoundary()
+    {
+        bool ret = grdpProgressBeginStep(pRti_, 1);
+        if (!ret || (BoundaryNever == boundary_)) {
+            // nothing to do
+        }
+        else if (!gridIs3D_) {
+            grdpSendWarningMsg(pRti_, "ExtractBoundary ignored for a 2D grid",
+                0);
+        }
+        else if ((BoundaryNoMarkers == boundary_) && hasMarkers()) {
+            // The file's markers are the boundary
+        }
+        else if (nElems_ != store_.size()) {
+            reportError("Boundary extraction requires all element data to be "
+                "staged. Increase StagingMemoryLimit", std::string());
+            ret = false;
+        }
+        else {
+            BoundaryFaces::FaceArray1 faces;
+            BoundaryFaces::find(store_, numThreads(), faces);
+            store_.clear();
+            PWGM_ELEMCOUNTS counts = ZeroCounts;
+            for (size_t ii = 0; ii < faces.size(); ++ii) {
+                ++(3 == faces[ii].cnt ? PWGM_ECNT_Tri(counts) :
+                    PWGM_ECNT_Quad(counts));
+            }
+            const PWGM_HDOMAIN hDom = PwVlstCreateUnsDomain(hVL_);
+            ret = PWGM_HDOMAIN_ISVALID(hDom) &&
+                PwUnsDomAllocateElementCounts(hDom, counts);
+            if (!ret) {
+                reportError("Could create boundary domain", std::string());
+            }
+            PWGM_ELEMDATA elem;
+            for (size_t ii = 0; ret && (ii < faces.size()); ++ii) {
+                const BoundaryFaces::Face &face = faces[ii];
+                elem.type = (3 == face.cnt) ? PWGM_ELEMTYPE_TRI :
+                    PWGM_ELEMTYPE_QUAD;
+                elem.vertCnt = face.cnt;
+                for (PWP_UINT32 jj = 0; jj < face.cnt; ++jj) {
+                    elem.index[jj] = used_.size() ?
+                        used_.rank(face.verts[jj]) : face.verts[jj];
+                }
+                if (!PwUnsDomSetElement(hDom, PWP_UINT32(ii), &elem)) {
+                    reportError("Could not set boundary element data",
+                        std::string());
+                    ret = false;
+                }
+            }
+            if (ret) {
+                std::ostringstream oss;
+                oss << "Extracted " << faces.size() << " boundary faces";
+                grdpSendInfoMsg(pRti_, oss.str().c_str(), 0);
+            }
+        }
+        store_.clear();
+        return grdpProgressEndStep(pRti_) && ret;
+    }
+
+
+    // Returns true if the ParserVerify attribute is set.
+    bool
+    parserVerify() const
+    {
+        PWP_BOOL verify = PWP_FALSE;
+        return PwModGetAttributeBOOL(pRti_->model, "ParserVerify", &verify) &&
+            verify;
+    }
+
+
+    // The number of progress steps of the import. A streamed import reads
+    // the header, stages the cells, reads the points, loads the cells and
+    // extracts the boundary. A seekable import scans the header, stages the
+    // cells, loads the cells and extracts the boundary, after verifying the
+    // parsers if ParserVerify is set.
+    PWP_UINT32
+    numMajorSteps() const
+    {
+        return (streaming_ || parserVerify()) ? 5 : 4;
+    }
+
+
+    // The number of boundary extraction threads as decided by plan().
+    PWP_UINT32
+    numThreads() const
+    {
+        return threads_;
+    }
+
     // hide copy constructor
     SU2GridReader(const SU2GridReader&) {}
 
@@ -693,13 +2907,26 @@ private:
 private:
     GRDP_RTITEM *       pRti_;          // the rti
     PwpFile             in_;            // input file
-    std::string         line_;          // Current file line being processed
+    SU2LegacyParser     legacy_;        // the Legacy parser engine
+    SU2FastParser       fast_;          // the Fast parser engine
+    SU2Parser *         parser_;        // the selected parser engine
     sysFILEPOS          posNELEMData_;  // cached file pos of element data
     sysFILEPOS          posNPOINData_;  // cached file pos of coord data
+    sysFILEPOS          posTailData_;   // cached file pos after init() scan
     bool                gridIs3D_;      // true if grid dimensionality is 3D
+    bool                streaming_;     // true if read in one forward pass
+    FILE *              pipe_;          // decompressor output or 0
+    const SU2Compression *compression_; // file compression format or 0
+    unsigned long long  fileSize_;      // file size in bytes, 0 if a pipe
+    PWP_UINT32          threads_;       // boundary extraction threads
+    size_t              bufSize_;       // input buffer size in bytes
+    Clock::time_point   startTime_;     // time the import started
+    BoundaryMode        boundary_;      // ExtractBoundary attribute value
+    SU2ElemStore        store_;         // staged element connectivity
     PWP_UINT32          nPoints_;       // total number of uns vertices
     PWP_UINT32          nElems_;        // total number of elements
     PWGM_ELEMCOUNTS     nElemTypes_;    // number of elements by type
+    VertexMask          used_;          // points used by a subset import
     PWGM_HVERTEXLIST    hVL_;           // the grid's uns vertex list
 };
 
@@ -724,13 +2951,62 @@ assignValueEnum(const char name[], const char value[], bool createIfNotExists)
 }
 
 
+PWP_BOOL
+publishValueDef(const char name[], PWP_ENUM_VALTYPE type, const char value[],
+    const char range[], const char desc[])
+{
+    return PwuPublishValueDefinition(name, type, value, "RW", desc, range);
+}
+
+
 PWP_BOOL
 runtimeReadGridCreate(GRDP_RTITEM * /*pRti*/)
 {
     PWP_BOOL ret = PWP_TRUE;
     // Publish the element types supported by this importer
-    const char *etypes = "Bar|Tri|Quad|Tet|Pyramid|Wedge|Hex";
-    ret = ret && assignValueEnum("ValidElements", etypes, true);
+    std::string etypes;
+    for (size_t ii = 0; ii < SU2NumElemTypes; ++ii) {
+        etypes += (ii ? "|" : "");
+        etypes += SU2ElemInfos[ii].name;
+    }
+    ret = ret && assignValueEnum("ValidElements", etypes.c_str(), true);
+    // Publish the import attributes supported by this importer
+    ret = ret && publishValueDef("ImportBackend", PWP_VALTYPE_ENUM, "Auto",
+        "Auto|Seekable|Stream", "How the file is read. Auto plans from the "
+        "file and system. Pipes and compressed files are streamed in a "
+        "single forward-only pass. Other files are read with positioning.");
+    ret = ret && publishValueDef("ImportDecompress", PWP_VALTYPE_BOOL,
+        "false", "", "Read gzip, bzip2, xz and zstd compressed files through "
+        "'gzip -dc', 'bzip2 -dc', 'xz -dc' or 'zstd -dc'. The command is run "
+        "by /bin/sh and must be on the PATH of the application. Not "
+        "supported on Windows.");
+    ret = ret && publishValueDef("ImportBufferSize", PWP_VALTYPE_UINT, "0",
+        "0 +inf", "Input buffer size in KB. 0 sizes it from the file.");
+    ret = ret && publishValueDef("StagingMemoryLimit", PWP_VALTYPE_UINT, "0",
+        "0 +inf", "Max MB used to stage element connectivity. 0 is "
+        "unlimited.");
+    ret = ret && publishValueDef("SubsetTypes", PWP_VALTYPE_STRING, "", "",
+        "Only import cells of these types (e.g. 'Tet|Wedge'). The types must "
+        "match the grid's dimensionality. Empty imports all types.");
+    ret = ret && publishValueDef("SubsetBox", PWP_VALTYPE_STRING, "", "",
+        "Only import cells with a point in the box 'xmin ymin zmin xmax ymax "
+        "zmax'. Empty disables the box.");
+    ret = ret && publishValueDef("SubsetMarkers", PWP_VALTYPE_STRING, "", "",
+        "Only import cells near these markers (e.g. 'wall,body'). Empty "
+        "disables the marker filter.");
+    ret = ret && publishValueDef("SubsetLayers", PWP_VALTYPE_UINT, "1",
+        "1 +inf", "Number of cell layers imported around SubsetMarkers.");
+    ret = ret && publishValueDef("ExtractBoundary", PWP_VALTYPE_ENUM, "Never",
+        "Never|NoMarkers|Always", "Derive the exterior boundary of a 3D grid "
+        "from its cells and import it as a domain.");
+    ret = ret && publishValueDef("ImportThreads", PWP_VALTYPE_UINT, "0",
+        "0 +inf", "Max threads used for boundary extraction. Parsing uses one "
+        "thread. 0 plans from the file size and core count.");
+    ret = ret && publishValueDef("ParserEngine", PWP_VALTYPE_ENUM, "Legacy",
+        "Legacy|Fast", "The engine used to parse the grid file.");
+    ret = ret && publishValueDef("ParserVerify", PWP_VALTYPE_BOOL, "false", "",
+        "Parse the grid file with the Legacy and Fast engines before the "
+        "import and fail on the first difference.");
     return ret;
 }
 
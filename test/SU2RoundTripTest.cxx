@@ -0,0 +1,506 @@
+/****************************************************************************
+ *
+ * (C) 2021 Cadence Design Systems, Inc. All rights reserved worldwide.
+ *
+ * This sample source code is not supported by Cadence Design Systems, Inc.
+ * It is provided freely for demonstration purposes only.
+ * SEE THE WARRANTY DISCLAIMER AT THE BOTTOM OF THIS FILE.
+ *
+ ***************************************************************************/
+/****************************************************************************
+*
+* SU2 round trip parity and throughput test
+*
+* Writes 2D and 3D grids with SU2GridWriter, imports them with
+* runtimeReadGrid(), writes the imported grids again and checks that:
+*   - the vertices and elements given to the grid model match the source
+*   - the rewritten file is byte-identical to the written file
+* for each parser engine, import backend and thread count. The write and
+* import throughputs are printed.
+*
+* The test stands in for the host application. It implements the grid model
+* and GRDP utility functions used by the plugin and records the imported
+* grid. Build it in the plugin's directory of a PluginSDK installation with
+* the plugin sources and the shared PwpFile sources, for example:
+*
+*   g++ -std=c++11 -O2 -pthread -I. -I../shared/PWP -I../shared/PWGM
+*       -I../shared/GRDP test/SU2RoundTripTest.cxx runtimeReadGrid.cxx
+*       ../shared/PWP/PwpFile.cxx ../shared/PWP/pwpPlatform.cxx
+*       -o SU2RoundTripTest
+*
+* Usage: SU2RoundTripTest [cellsPerSide]
+* Returns 0 if all checks pass.
+*
+***************************************************************************/
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "apiGRDP.h"
+#include "apiGRDPUtils.h"
+#include "apiGridModel.h"
+#include "runtimeReadGrid.h"
+#include "SU2GridWriter.h"
+
+
+typedef std::vector<unsigned int>           UIntArray1;
+typedef std::vector<double>                 RealArray1;
+typedef std::map<std::string, std::string>  AttrMap;
+typedef std::chrono::steady_clock           Clock;
+
+// A grid as written to and read from an SU2 file
+struct Grid {
+    unsigned int    dimty;  // 2 or 3
+    UIntArray1      types;  // SU2 type of each element
+    UIntArray1      conn;   // element vertex indices
+    RealArray1      xyz;    // point coordinates
+};
+
+// The grid model built by the import
+static AttrMap      Attrs;          // import attribute values
+static Grid         Imported;       // imported vertices and elements
+static size_t       NumEntities;    // blocks and domains created
+
+
+//---------------------------------------------------------------------------
+// Grid model and GRDP utility functions used by the plugin
+//---------------------------------------------------------------------------
+
+PWGM_HVERTEXLIST
+PwModCreateUnsVertexList(PWGM_HGRIDMODEL model)
+{
+    PWGM_HVERTEXLIST ret;
+    PWGM_HVERTEXLIST_SET(ret, model, 0);
+    return ret;
+}
+
+
+PWP_BOOL
+PwVlstAllocate(PWGM_HVERTEXLIST /*vertlist*/, const PWP_UINT32 n)
+{
+    Imported.xyz.assign(size_t(n) * Imported.dimty, 0.0);
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwVlstSetXYZData(PWGM_HVERTEXLIST /*vertlist*/, const PWP_UINT32 ndx,
+    const PWGM_VERTDATA &v)
+{
+    const size_t off = size_t(ndx) * Imported.dimty;
+    if (off >= Imported.xyz.size()) {
+        return PWP_FALSE;
+    }
+    Imported.xyz[off] = v.x;
+    Imported.xyz[off + 1] = v.y;
+    if (3 == Imported.dimty) {
+        Imported.xyz[off + 2] = v.z;
+    }
+    return PWP_TRUE;
+}
+
+
+PWGM_HBLOCK
+PwVlstCreateUnsBlock(PWGM_HVERTEXLIST /*vertlist*/)
+{
+    PWGM_HBLOCK ret;
+    PWGM_HBLOCK_SET(ret, PWGM_HGRIDMODEL_INIT, PWP_UINT32(NumEntities++));
+    return ret;
+}
+
+
+PWGM_HDOMAIN
+PwVlstCreateUnsDomain(PWGM_HVERTEXLIST /*vertlist*/)
+{
+    PWGM_HDOMAIN ret;
+    PWGM_HDOMAIN_SET(ret, PWGM_HGRIDMODEL_INIT, PWP_UINT32(NumEntities++));
+    return ret;
+}
+
+
+PWP_BOOL
+PwUnsBlkAllocateElementCounts(PWGM_HBLOCK /*block*/,
+    const PWGM_ELEMCOUNTS &/*counts*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwUnsDomAllocateElementCounts(PWGM_HDOMAIN /*domain*/,
+    const PWGM_ELEMCOUNTS &/*counts*/)
+{
+    return PWP_TRUE;
+}
+
+
+// Record an element of the first (grid) entity. Its SU2 type is found from
+// its vertex count and the grid dimensionality.
+static PWP_BOOL
+setElement(PWP_UINT32 entity, const PWGM_ELEMDATA *pElemData)
+{
+    if (0 == entity) {
+        const PWP_UINT32 cnt = pElemData->vertCnt;
+        unsigned int type = 0;
+        for (size_t ii = 0; ii < SU2NumElemTypes; ++ii) {
+            if ((SU2ElemInfos[ii].vertCnt == cnt) &&
+                    (SU2ElemInfos[ii].dimty == Imported.dimty)) {
+                type = SU2ElemInfos[ii].type;
+            }
+        }
+        Imported.types.push_back(type);
+        Imported.conn.insert(Imported.conn.end(), pElemData->index,
+            pElemData->index + cnt);
+    }
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwUnsBlkSetElement(PWGM_HBLOCK block, const PWP_UINT32 /*ndx*/,
+    const PWGM_ELEMDATA *pElemData)
+{
+    return setElement(PWGM_HBLOCK_ID(block), pElemData);
+}
+
+
+PWP_BOOL
+PwUnsDomSetElement(PWGM_HDOMAIN domain, const PWP_UINT32 /*ndx*/,
+    const PWGM_ELEMDATA *pElemData)
+{
+    return setElement(PWGM_HDOMAIN_ID(domain), pElemData);
+}
+
+
+PWP_BOOL
+PwModGetAttributeString(PWGM_HGRIDMODEL /*model*/, const char *name,
+    const char **val)
+{
+    const AttrMap::const_iterator it = Attrs.find(name);
+    if (Attrs.end() == it) {
+        return PWP_FALSE;
+    }
+    *val = it->second.c_str();
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwModGetAttributeUINT32(PWGM_HGRIDMODEL model, const char *name,
+    PWP_UINT32 *val)
+{
+    const char *str = 0;
+    if (!PwModGetAttributeString(model, name, &str)) {
+        return PWP_FALSE;
+    }
+    *val = PWP_UINT32(strtoul(str, 0, 10));
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwModGetAttributeBOOL(PWGM_HGRIDMODEL model, const char *name, PWP_BOOL *val)
+{
+    const char *str = 0;
+    if (!PwModGetAttributeString(model, name, &str)) {
+        return PWP_FALSE;
+    }
+    *val = (0 == strcmp(str, "true")) ? PWP_TRUE : PWP_FALSE;
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+grdpProgressInit(GRDP_RTITEM * /*pRti*/, PWP_UINT32 /*cnt*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+grdpProgressBeginStep(GRDP_RTITEM * /*pRti*/, PWP_UINT32 /*total*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+grdpProgressEndStep(GRDP_RTITEM * /*pRti*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+grdpProgressIncr(GRDP_RTITEM * /*pRti*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+grdpProgressEnd(GRDP_RTITEM * /*pRti*/, PWP_BOOL ok)
+{
+    return ok;
+}
+
+
+void
+grdpSendErrorMsg(GRDP_RTITEM * /*pRti*/, const char msg[], PWP_UINT32 /*id*/)
+{
+    fprintf(stderr, "  error: %s\n", msg);
+}
+
+
+void
+grdpSendWarningMsg(GRDP_RTITEM * /*pRti*/, const char msg[],
+    PWP_UINT32 /*id*/)
+{
+    fprintf(stderr, "  warning: %s\n", msg);
+}
+
+
+void
+grdpSendInfoMsg(GRDP_RTITEM * /*pRti*/, const char msg[], PWP_UINT32 /*id*/)
+{
+    // Only report the throughput
+    if (0 == strncmp(msg, "Imported ", 9)) {
+        printf("  %s\n", msg);
+    }
+}
+
+
+PWP_BOOL
+PwuAssignValueEnum(const char /*group*/[], const char /*name*/[],
+    const char /*value*/[], bool /*createIfNotExists*/)
+{
+    return PWP_TRUE;
+}
+
+
+PWP_BOOL
+PwuPublishValueDefinition(const char /*key*/[], PWP_ENUM_VALTYPE /*type*/,
+    const char /*value*/[], const char /*access*/[], const char /*desc*/[],
+    const char /*range*/[])
+{
+    return PWP_TRUE;
+}
+
+
+//---------------------------------------------------------------------------
+// Test
+//---------------------------------------------------------------------------
+
+// Make an n x n (x n) grid of unit size. 3D grids mix hex, wedge, pyramid
+// and tet cells. 2D grids mix quad and tri cells. The coordinates are
+// perturbed so they need all 17 digits to round trip.
+static void
+makeGrid(unsigned int dimty, unsigned int n, Grid &grid)
+{
+    grid = Grid();
+    grid.dimty = dimty;
+    const unsigned int nk = (3 == dimty) ? n : 0;
+    for (unsigned int k = 0; k <= nk; ++k) {
+        for (unsigned int j = 0; j <= n; ++j) {
+            for (unsigned int i = 0; i <= n; ++i) {
+                grid.xyz.push_back(double(i) / n + 1e-9 * std::sin(i + j));
+                grid.xyz.push_back(double(j) / 3.0 - 1e-300);
+                if (3 == dimty) {
+                    grid.xyz.push_back(-double(k) / 7.0);
+                }
+            }
+        }
+    }
+    const unsigned int n1 = n + 1;
+    for (unsigned int k = 0; k < std::max(nk, 1U); ++k) {
+        for (unsigned int j = 0; j < n; ++j) {
+            for (unsigned int i = 0; i < n; ++i) {
+                const unsigned int v0 = (k * n1 + j) * n1 + i;
+                const unsigned int q[4] = { v0, v0 + 1, v0 + n1 + 1,
+                    v0 + n1 };
+                const unsigned int sel = (i + j + k) % 4;
+                if (2 == dimty) {
+                    if (sel < 2) {
+                        grid.types.push_back(SU2Quad);
+                        grid.conn.insert(grid.conn.end(), q, q + 4);
+                    }
+                    else {
+                        const unsigned int tri[6] = { q[0], q[1], q[2],
+                            q[0], q[2], q[3] };
+                        grid.types.push_back(SU2Tri);
+                        grid.types.push_back(SU2Tri);
+                        grid.conn.insert(grid.conn.end(), tri, tri + 6);
+                    }
+                    continue;
+                }
+                const unsigned int up = n1 * n1;
+                const unsigned int hex[8] = { q[0], q[1], q[2], q[3],
+                    q[0] + up, q[1] + up, q[2] + up, q[3] + up };
+                // The cells need not be conforming for this test
+                static const SU2ElemType Types[4] = { SU2Hex, SU2Wedge,
+                    SU2Pyramid, SU2Tet };
+                const SU2ElemType type = Types[sel];
+                grid.types.push_back(type);
+                grid.conn.insert(grid.conn.end(), hex,
+                    hex + su2ElemInfo(type)->vertCnt);
+            }
+        }
+    }
+}
+
+
+// Write grid to path without markers using numThreads threads and print
+// the throughput.
+static bool
+writeGrid(const Grid &grid, const char *path, unsigned int numThreads)
+{
+    const Clock::time_point start = Clock::now();
+    FILE *fp = fopen(path, "wb");
+    SU2GridWriter writer(fp, numThreads);
+    writer.writeDimension(grid.dimty) &&
+        writer.writeElements(grid.types.data(), grid.types.size(),
+            grid.conn.data()) &&
+        writer.writePoints(grid.xyz.data(), grid.xyz.size() / grid.dimty) &&
+        writer.writeMarkerCount(0);
+    const long bytes = fp ? ftell(fp) : 0;
+    const bool ret = writer.ok() && fp && (0 == fclose(fp));
+    const double secs = std::chrono::duration<double>(Clock::now() -
+        start).count();
+    if (ret) {
+        printf("  Wrote %lu points and %lu elements in %.2f s",
+            (unsigned long)(grid.xyz.size() / grid.dimty),
+            (unsigned long)grid.types.size(), secs);
+        if ((0 < bytes) && (0.0 < secs)) {
+            printf(" (%.2f MB/s written)", double(bytes) / double(1 << 20) /
+                secs);
+        }
+        printf("\n");
+    }
+    return ret;
+}
+
+
+// Returns true if the files at path1 and path2 have the same bytes.
+static bool
+sameFiles(const char *path1, const char *path2)
+{
+    FILE *fp1 = fopen(path1, "rb");
+    FILE *fp2 = fopen(path2, "rb");
+    bool ret = fp1 && fp2;
+    while (ret) {
+        const int c1 = fgetc(fp1);
+        ret = (c1 == fgetc(fp2));
+        if (EOF == c1) {
+            break;
+        }
+    }
+    if (fp1) {
+        fclose(fp1);
+    }
+    if (fp2) {
+        fclose(fp2);
+    }
+    return ret;
+}
+
+
+// Import the file at path with the given attributes. Check the imported
+// grid against grid. Write the imported grid to rewritePath with the
+// ImportThreads thread count and check it against the file at path.
+static bool
+roundTrip(const Grid &grid, const char *path, const char *rewritePath,
+    const AttrMap &attrs)
+{
+    Attrs = attrs;
+    Imported = Grid();
+    Imported.dimty = grid.dimty;
+    NumEntities = 0;
+    GRDP_READINFO readInfo;
+    memset(&readInfo, 0, sizeof(readInfo));
+    readInfo.fileDest = path;
+    GRDP_RTITEM rti;
+    memset(&rti, 0, sizeof(rti));
+    rti.pReadInfo = &readInfo;
+    bool ret = runtimeReadGridCreate(&rti) && runtimeReadGrid(&rti);
+    if (!ret) {
+        printf("  FAIL: import failed\n");
+    }
+    else if ((Imported.types != grid.types) || (Imported.conn != grid.conn)) {
+        printf("  FAIL: imported elements differ\n");
+        ret = false;
+    }
+    else if (0 != memcmp(Imported.xyz.data(), grid.xyz.data(),
+            grid.xyz.size() * sizeof(double))) {
+        printf("  FAIL: imported vertices differ\n");
+        ret = false;
+    }
+    else if (!writeGrid(Imported, rewritePath,
+            unsigned(atoi(Attrs["ImportThreads"].c_str())))) {
+        printf("  FAIL: could not write '%s'\n", rewritePath);
+        ret = false;
+    }
+    else if (!sameFiles(path, rewritePath)) {
+        printf("  FAIL: rewritten file differs from '%s'\n", path);
+        ret = false;
+    }
+    runtimeReadGridDestroy(&rti);
+    return ret;
+}
+
+
+int
+main(int argc, char *argv[])
+{
+    const unsigned int n = (argc > 1) ? unsigned(atoi(argv[1])) : 24;
+    const char *path = "SU2RoundTripTest.su2";
+    const char *rewritePath = "SU2RoundTripTest.rewrite.su2";
+    static const char *Engines[] = { "Legacy", "Fast" };
+    static const char *Backends[] = { "Seekable", "Stream" };
+    static const char *Threads[] = { "1", "4" };
+    bool ok = true;
+    for (unsigned int dimty = 2; dimty <= 3; ++dimty) {
+        Grid grid;
+        makeGrid(dimty, (2 == dimty) ? n * 8 : n, grid);
+        printf("%uD:\n", dimty);
+        if (!writeGrid(grid, path, 1)) {
+            printf("FAIL: could not write '%s'\n", path);
+            return 1;
+        }
+        for (int ii = 0; ii < 2; ++ii) {
+            for (int jj = 0; jj < 2; ++jj) {
+                for (int kk = 0; kk < 2; ++kk) {
+                    AttrMap attrs;
+                    attrs["ParserEngine"] = Engines[ii];
+                    attrs["ImportBackend"] = Backends[jj];
+                    attrs["ImportThreads"] = Threads[kk];
+                    printf(" %s %s %s threads\n", Engines[ii], Backends[jj],
+                        Threads[kk]);
+                    ok = roundTrip(grid, path, rewritePath, attrs) && ok;
+                }
+            }
+        }
+    }
+    remove(path);
+    remove(rewritePath);
+    printf("%s\n", ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+
+/****************************************************************************
+ *
+ * This file is licensed under the Cadence Public License Version 1.0 (the
+ * "License"), a copy of which is found in the included file named "LICENSE",
+ * and is distributed "AS IS." TO THE MAXIMUM EXTENT PERMITTED BY APPLICABLE
+ * LAW, CADENCE DISCLAIMS ALL WARRANTIES AND IN NO EVENT SHALL BE LIABLE TO
+ * ANY PARTY FOR ANY DAMAGES ARISING OUT OF OR RELATING TO USE OF THIS FILE.
+ * Please see the License for the full text of applicable terms.
+ *
+ ****************************************************************************/